@@ -0,0 +1,138 @@
+#include "CV8Resource.h"
+#include "V8Helpers.h"
+
+#include "AssetRequests.h"
+
+using Type = V8Helpers::AssetRequests::Type;
+using Asset = V8Helpers::AssetRequests::Asset;
+
+struct AssetTypeInfo
+{
+    const char* name;
+    // Shown in errors
+    const char* displayName;
+    const char* requestNative;
+    const char* hasLoadedNative;
+};
+
+static const AssetTypeInfo assetTypes[] = {
+    { "model", "model", "requestModel", "hasModelLoaded" },
+    { "animDict", "anim dict", "requestAnimDict", "hasAnimDictLoaded" },
+    { "animSet", "anim set", "requestAnimSet", "hasAnimSetLoaded" },
+    { "clipSet", "clip set", "requestClipSet", "hasClipSetLoaded" },
+    { "cutscene", "cutscene", "requestCutscene", "hasCutsceneLoaded" },
+};
+
+static alt::INative* GetNative(const char* name)
+{
+    // Natives are the same for every resource, so they are only looked up once
+    static std::unordered_map<std::string, alt::INative*> natives;
+    if(natives.empty())
+    {
+        for(auto native : alt::ICore::Instance().GetAllNatives()) natives[native->GetName().ToString()] = native;
+    }
+
+    auto it = natives.find(name);
+    if(it == natives.end() || !it->second->IsValid()) return nullptr;
+    return it->second;
+}
+
+static bool CallNative(const char* name, const Asset& asset, bool request)
+{
+    static auto ctx = alt::ICore::Instance().CreateNativesContext();
+
+    alt::INative* native = GetNative(name);
+    if(!native) return false;
+
+    ctx->Reset();
+    if(asset.type == Type::MODEL) ctx->Push(asset.hash);
+    // hasCutsceneLoaded doesn't take the name, it checks the cutscene that was requested last
+    else if(request || asset.type != Type::CUTSCENE)
+        ctx->Push((char*)asset.name.c_str());
+    if(request && asset.type == Type::CUTSCENE) ctx->Push(asset.flags);
+
+    if(!native->Invoke(ctx)) return false;
+    return !request && ctx->ResultBool();
+}
+
+static bool HasLoaded(const Asset& asset)
+{
+    return CallNative(assetTypes[(int)asset.type].hasLoadedNative, asset, false);
+}
+
+bool V8Helpers::AssetRequests::GetType(const std::string& name, Type& type)
+{
+    for(size_t i = 0; i < std::size(assetTypes); i++)
+    {
+        if(name != assetTypes[i].name) continue;
+        type = (Type)i;
+        return true;
+    }
+    return false;
+}
+
+v8::Local<v8::Promise> V8Helpers::AssetRequests::Add(CV8ResourceImpl* resource, std::vector<Asset>&& assets, uint32_t timeout)
+{
+    v8::Isolate* isolate = resource->GetIsolate();
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(resource->GetContext()).ToLocalChecked();
+
+    size_t pending = 0;
+    for(Asset& asset : assets)
+    {
+        CallNative(assetTypes[(int)asset.type].requestNative, asset, true);
+        // Assets that are already streamed in don't have to wait for the next tick
+        asset.loaded = HasLoaded(asset);
+        if(!asset.loaded) pending++;
+    }
+
+    if(pending == 0) resolver->Resolve(resource->GetContext(), v8::Undefined(isolate));
+    else
+        requests.push_back(Request{ std::move(assets), pending, resource->GetTime() + timeout, { isolate, resolver } });
+
+    return resolver->GetPromise();
+}
+
+void V8Helpers::AssetRequests::ProcessQueue(CV8ResourceImpl* resource)
+{
+    if(requests.empty()) return;
+
+    v8::Isolate* isolate = resource->GetIsolate();
+    v8::Local<v8::Context> ctx = resource->GetContext();
+    int64_t now = resource->GetTime();
+
+    // Settled after the loop, so nothing that runs when settling can modify the list while it is checked
+    std::list<Request> finished;
+    for(auto it = requests.begin(); it != requests.end();)
+    {
+        Request& request = *it;
+        for(Asset& asset : request.assets)
+        {
+            if(asset.loaded || !HasLoaded(asset)) continue;
+            asset.loaded = true;
+            request.pending--;
+        }
+
+        if(request.pending != 0 && now <= request.deadline)
+        {
+            ++it;
+            continue;
+        }
+        auto next = std::next(it);
+        finished.splice(finished.end(), requests, it);
+        it = next;
+    }
+
+    for(Request& request : finished)
+    {
+        v8::Local<v8::Promise::Resolver> resolver = request.resolver.Get(isolate);
+        if(request.pending == 0)
+        {
+            resolver->Resolve(ctx, v8::Undefined(isolate));
+            continue;
+        }
+
+        const Asset& failed = *std::find_if(request.assets.begin(), request.assets.end(), [](const Asset& asset) { return !asset.loaded; });
+        std::string errorMsg = std::string("Failed to request ") + assetTypes[(int)failed.type].displayName + " '" + failed.name + "'";
+        resolver->Reject(ctx, v8::Exception::Error(V8Helpers::JSValue(errorMsg)));
+    }
+}
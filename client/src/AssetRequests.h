@@ -0,0 +1,62 @@
+#pragma once
+
+#include "v8.h"
+#include "V8Helpers.h"
+
+#include <list>
+
+class CV8ResourceImpl;
+
+namespace V8Helpers
+{
+    // Streaming requests of game assets, the load state of all outstanding requests is checked once per tick
+    class AssetRequests
+    {
+    public:
+        enum class Type
+        {
+            MODEL,
+            ANIM_DICT,
+            ANIM_SET,
+            CLIP_SET,
+            CUTSCENE
+        };
+
+        struct Asset
+        {
+            Type type;
+            // Name shown in errors, models are requested by their hash
+            std::string name;
+            uint32_t hash = 0;
+            int32_t flags = 0;
+            bool loaded = false;
+        };
+
+        // Returns false if the name is not a known asset type
+        static bool GetType(const std::string& name, Type& type);
+
+        // Requests the assets, the promise is resolved once all of them are loaded or rejected after the timeout in milliseconds
+        v8::Local<v8::Promise> Add(CV8ResourceImpl* resource, std::vector<Asset>&& assets, uint32_t timeout);
+        void ProcessQueue(CV8ResourceImpl* resource);
+
+        void Clear()
+        {
+            requests.clear();
+        }
+        size_t GetSize() const
+        {
+            return requests.size();
+        }
+
+    private:
+        struct Request
+        {
+            std::vector<Asset> assets;
+            size_t pending;
+            int64_t deadline;
+            V8Helpers::CPersistent<v8::Promise::Resolver> resolver;
+        };
+
+        std::list<Request> requests;
+    };
+}  // namespace V8Helpers
@@ -0,0 +1,174 @@
+#include "CCodeCache.h"
+#include "Log.h"
+
+#include "cpp-sdk/ICore.h"
+
+#include <fstream>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+
+// !!! Increase the version when changing the file layout !!!
+static const char cacheMagic[] = { 'A', 'L', 'T', 'C', 'C', 2 };
+
+// SHA-256 in hex
+static constexpr size_t HashLength = 64;
+
+struct CacheHeader
+{
+    char magic[sizeof(cacheMagic)];
+    char sourceHash[HashLength];
+    uint64_t sourceSize;
+};
+
+std::string CCodeCache::Hash(const std::string& source)
+{
+    // Seeded with the V8 version so caches of other V8 builds are never picked up.
+    // Has to be collision resistant, a cache is used for any source with the same hash
+    return alt::ICore::Instance().StringToSHA256(std::string(v8::V8::GetVersion()) + '\0' + source);
+}
+
+std::filesystem::path CCodeCache::GetServerDirectory()
+{
+    std::string server = alt::ICore::Instance().GetServerIp().ToString() + ":" + std::to_string(alt::ICore::Instance().GetServerPort());
+    // Only computed again once the player connects to another server
+    static std::string lastServer;
+    static std::string serverHash;
+    if(server != lastServer)
+    {
+        lastServer = server;
+        serverHash = alt::ICore::Instance().StringToSHA256(server).substr(0, 16);
+    }
+    return directory / serverHash;
+}
+
+std::filesystem::path CCodeCache::GetFilePath(const std::string& hash)
+{
+    return GetServerDirectory() / (hash + ".jsc");
+}
+
+v8::ScriptCompiler::CachedData* CCodeCache::Load(const std::string& hash, size_t sourceSize)
+{
+    if(!enabled || directory.empty() || hash.size() != HashLength) return nullptr;
+
+    std::ifstream file(GetFilePath(hash), std::ios::binary | std::ios::ate);
+    if(!file.good()) return nullptr;
+
+    std::streamoff fileSize = file.tellg();
+    if(fileSize <= (std::streamoff)sizeof(CacheHeader)) return nullptr;
+    file.seekg(0);
+
+    CacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader));
+    if(!file.good() || memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || memcmp(header.sourceHash, hash.data(), HashLength) != 0 ||
+       header.sourceSize != sourceSize) return nullptr;
+
+    size_t dataSize = (size_t)fileSize - sizeof(CacheHeader);
+    uint8_t* data = new uint8_t[dataSize];
+    file.read(reinterpret_cast<char*>(data), dataSize);
+    if(!file.good())
+    {
+        delete[] data;
+        return nullptr;
+    }
+
+    // The write time is the last time the cache was used, so caches that are still used are not trimmed
+    std::error_code error;
+    std::filesystem::last_write_time(GetFilePath(hash), std::filesystem::file_time_type::clock::now(), error);
+
+    return new v8::ScriptCompiler::CachedData(data, (int)dataSize, v8::ScriptCompiler::CachedData::BufferOwned);
+}
+
+void CCodeCache::Add(v8::Isolate* isolate, const std::string& hash, size_t sourceSize, v8::Local<v8::Module> module)
+{
+    if(!enabled || directory.empty() || hash.size() != HashLength) return;
+
+    pending.push_back(PendingModule{ hash, sourceSize, v8::UniquePersistent<v8::UnboundModuleScript>{ isolate, module->GetUnboundModuleScript() } });
+}
+
+void CCodeCache::Remove(const std::string& hash)
+{
+    std::error_code error;
+    std::filesystem::remove(GetFilePath(hash), error);
+}
+
+void CCodeCache::Flush(v8::Isolate* isolate)
+{
+    if(pending.empty()) return;
+
+    v8::HandleScope handleScope(isolate);
+
+    std::error_code error;
+    std::filesystem::path serverDirectory = GetServerDirectory();
+    std::filesystem::create_directories(serverDirectory, error);
+    if(error)
+    {
+        Log::Error << "[V8] Failed to create code cache directory " << serverDirectory.string() << ": " << error.message() << Log::Endl;
+        pending.clear();
+        return;
+    }
+
+    for(PendingModule& entry : pending)
+    {
+        std::unique_ptr<v8::ScriptCompiler::CachedData> cache{ v8::ScriptCompiler::CreateCodeCache(entry.script.Get(isolate)) };
+        if(!cache) continue;
+
+        CacheHeader header;
+        memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+        memcpy(header.sourceHash, entry.hash.data(), HashLength);
+        header.sourceSize = entry.sourceSize;
+
+        std::filesystem::path path = GetFilePath(entry.hash);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+        file.write(reinterpret_cast<const char*>(cache->data), cache->length);
+        if(!file.good())
+        {
+            file.close();
+            std::filesystem::remove(path, error);
+        }
+    }
+
+    pending.clear();
+}
+
+void CCodeCache::Trim()
+{
+    if(directory.empty()) return;
+
+    struct Entry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUsed;
+        uintmax_t size;
+    };
+    std::vector<Entry> entries;
+
+    std::error_code error;
+    std::filesystem::file_time_type now = std::filesystem::file_time_type::clock::now();
+    // Also goes over the directories of the other servers
+    for(auto it = std::filesystem::recursive_directory_iterator(directory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+        if(!it->is_regular_file(error) || it->path().extension() != ".jsc") continue;
+
+        std::filesystem::file_time_type lastUsed = it->last_write_time(error);
+        if(error) continue;
+        if(now - lastUsed > MaxAge)
+        {
+            std::filesystem::remove(it->path(), error);
+            continue;
+        }
+        entries.push_back(Entry{ it->path(), lastUsed, it->file_size(error) });
+    }
+
+    uintmax_t totalSize = 0;
+    for(Entry& entry : entries) totalSize += entry.size;
+    if(totalSize <= MaxSize) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+    for(Entry& entry : entries)
+    {
+        if(totalSize <= MaxSize) break;
+        if(std::filesystem::remove(entry.path, error)) totalSize -= entry.size;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+
+#include "v8.h"
+
+// On-disk cache of compiled ES modules, keyed by the SHA-256 hash of the module source.
+// Caches are created once the resource was started, so they also contain everything compiled while evaluating the modules.
+// Every server gets its own directory, so modules of one server can never be run from the cache for another server
+class CCodeCache
+{
+    struct PendingModule
+    {
+        std::string hash;
+        size_t sourceSize;
+        v8::UniquePersistent<v8::UnboundModuleScript> script;
+    };
+
+    // Caches that weren't used for this long are deleted, and the oldest ones once all of them are larger than the limit
+    static constexpr auto MaxAge = std::chrono::hours(24 * 30);
+    static constexpr uintmax_t MaxSize = 64 * 1024 * 1024;
+
+    bool enabled = true;
+    // Contains a directory per server
+    std::filesystem::path directory;
+    // Modules that were compiled without a (valid) cache, written to disk on the next flush
+    std::vector<PendingModule> pending;
+
+    std::filesystem::path GetServerDirectory();
+    std::filesystem::path GetFilePath(const std::string& hash);
+
+public:
+    static CCodeCache& Instance()
+    {
+        static CCodeCache instance;
+        return instance;
+    }
+
+    // Hex encoded, unique for the source and the V8 version
+    static std::string Hash(const std::string& source);
+
+    bool IsEnabled() const
+    {
+        return enabled;
+    }
+    void SetIsEnabled(bool state)
+    {
+        enabled = state;
+    }
+    void SetDirectory(const std::filesystem::path& path)
+    {
+        directory = path;
+    }
+
+    // Returns the cached data for the source, or nullptr if there is none. Ownership is passed to the caller
+    v8::ScriptCompiler::CachedData* Load(const std::string& hash, size_t sourceSize);
+    // Marks the module to be cached, has to be called before the module is evaluated
+    void Add(v8::Isolate* isolate, const std::string& hash, size_t sourceSize, v8::Local<v8::Module> module);
+    void Remove(const std::string& hash);
+    // Writes the caches of all modules added since the last flush
+    void Flush(v8::Isolate* isolate);
+    // Deletes caches that weren't used for a long time and the least recently used ones past the size limit
+    void Trim();
+};
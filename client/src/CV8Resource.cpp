@@ -28,6 +28,7 @@
 #include "workers/CWorker.h"
 
 #include "JSBindings.h"
+#include "CCodeCache.h"
 
 extern void StaticRequire(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
@@ -66,6 +67,7 @@ extern V8Module altModule;
 bool CV8ResourceImpl::Start()
 {
     if(resource->GetMain().IsEmpty()) return false;
+    CTracer::Scope traceScope("resource", "Start", resource->GetName().CStr());
 
     resource->EnableNatives();
     auto nscope = resource->PushNativesScope();
@@ -137,13 +139,27 @@ bool CV8ResourceImpl::Start()
         ctx->Global()->Set(ctx, V8Helpers::JSValue("clearTimeout"), exports->Get(ctx, V8Helpers::JSValue("clearTimeout")).ToLocalChecked());
 
         ctx->Global()->Set(ctx, V8Helpers::JSValue("__internal_get_exports"), v8::Function::New(ctx, &StaticRequire).ToLocalChecked());
-        ctx->Global()->Set(ctx, V8Helpers::JSValue("__internal_bindings_code"), V8Helpers::JSValue(JSBindings::GetBindingsCode()));
+        v8::Local<v8::Function> bindings;
+        if(!JSBindings::Compile(ctx, { V8Helpers::JSValue("alt"), V8Helpers::JSValue("native") }).ToLocal(&bindings)) return false;
+        ctx->Global()->Set(ctx, V8Helpers::JSValue("__internal_bindings"), bindings);
 
+        int64_t startTime = GetMicroTime();
         bool res = curModule->InstantiateModule(ctx, CV8ScriptRuntime::ResolveModule).IsJust();
 
         if(!res) return false;
 
-        v8::MaybeLocal<v8::Value> v = curModule->Evaluate(ctx);
+        v8::MaybeLocal<v8::Value> v;
+        {
+            CWatchdog::Scope watchdogScope(isolate, executionTimeout);
+            v = curModule->Evaluate(ctx);
+            if(watchdogScope.Leave())
+            {
+                Log::Error << "[V8] Evaluating " << path << " exceeded " << executionTimeout << "ms and was terminated" << Log::Endl;
+                v = v8::MaybeLocal<v8::Value>();
+            }
+        }
+        stats.startTime = GetMicroTime() - startTime;
+        CTracer::Instance().Record("resource", "Evaluate", resource->GetName().CStr(), startTime, startTime + stats.startTime);
 
         isPreloading = false;
 
@@ -168,6 +184,9 @@ bool CV8ResourceImpl::Start()
         return true;
     });
 
+    // Modules were evaluated, so their caches now also contain the code compiled while starting
+    CCodeCache::Instance().Flush(isolate);
+
     DispatchStartEvent(!result);
 
     // if all resources are already loaded
@@ -181,6 +200,7 @@ bool CV8ResourceImpl::Start()
 
 bool CV8ResourceImpl::Stop()
 {
+    CTracer::Scope traceScope("resource", "Stop", resource->GetName().CStr());
     std::vector<alt::Ref<alt::IBaseObject>> objects(ownedObjects.size());
 
     for(auto handle : ownedObjects) objects.push_back(handle);
@@ -207,6 +227,7 @@ bool CV8ResourceImpl::Stop()
     rmlHandlers.clear();
 
     webViewsEventsQueue.clear();
+    assetRequests.Clear();
 
     localStorage.Reset();
 
@@ -224,6 +245,9 @@ bool CV8ResourceImpl::Stop()
         auto ctx = GetContext();
         v8::Context::Scope scope(ctx);
 
+        // Modules that were dynamically imported after the resource started
+        CCodeCache::Instance().Flush(isolate);
+
         auto resources = static_cast<CV8ScriptRuntime*>(resource->GetRuntime())->GetResources();
         auto name = this->resource->GetName().ToString();
         for(auto res : resources)
@@ -260,36 +284,39 @@ bool CV8ResourceImpl::OnEvent(const alt::CEvent* e)
     V8Helpers::EventHandler* handler = V8Helpers::EventHandler::Get(e);
     if(!handler) return true;
 
+    std::string traceName = CTracer::Instance().IsEnabled() ? GetEventTraceName(e) : std::string();
+    CTracer::Scope traceScope("event", traceName, resource->GetName().CStr());
+
     // Generic event handler
     {
         auto evType = e->GetType();
         if(evType == alt::CEvent::Type::CLIENT_SCRIPT_EVENT || evType == alt::CEvent::Type::SERVER_SCRIPT_EVENT)
         {
-            std::vector<V8Helpers::EventCallback*> callbacks;
+            const std::vector<V8Helpers::EventCallback*>* callbacks = nullptr;
             const char* eventName;
 
             if(evType == alt::CEvent::Type::CLIENT_SCRIPT_EVENT)
             {
-                callbacks = std::move(GetGenericHandlers(true));
+                callbacks = &GetGenericHandlers(true);
                 eventName = static_cast<const alt::CClientScriptEvent*>(e)->GetName().CStr();
             }
             else if(evType == alt::CEvent::Type::SERVER_SCRIPT_EVENT)
             {
-                callbacks = std::move(GetGenericHandlers(false));
+                callbacks = &GetGenericHandlers(false);
                 eventName = static_cast<const alt::CServerScriptEvent*>(e)->GetName().CStr();
             }
 
-            if(callbacks.size() != 0)
+            if(callbacks && callbacks->size() != 0)
             {
                 auto evArgs = handler->GetArgs(this, e);
                 evArgs.insert(evArgs.begin(), V8Helpers::JSValue(eventName));
 
-                InvokeEventHandlers(e, callbacks, evArgs);
+                InvokeEventHandlers(e, *callbacks, evArgs);
             }
         }
     }
 
-    std::vector<V8Helpers::EventCallback*> callbacks = handler->GetCallbacks(this, e);
+    const std::vector<V8Helpers::EventCallback*>& callbacks = handler->GetCallbacks(this, e);
     if(callbacks.size() > 0)
     {
         std::vector<v8::Local<v8::Value>> args = handler->GetArgs(this, e);
@@ -320,67 +347,41 @@ bool CV8ResourceImpl::OnEvent(const alt::CEvent* e)
         }
     }
 
+    if(e->GetType() == alt::CEvent::Type::RESOURCE_STOP) OnResourceStopped(static_cast<const alt::CResourceStopEvent*>(e)->GetResource());
+
     return true;
 }
 
-std::vector<V8Helpers::EventCallback*> CV8ResourceImpl::GetWebViewHandlers(alt::Ref<alt::IWebView> view, const std::string& name)
+const std::vector<V8Helpers::EventCallback*>& CV8ResourceImpl::GetWebViewHandlers(alt::Ref<alt::IWebView> view, const std::string& name)
 {
-    std::vector<V8Helpers::EventCallback*> handlers;
     auto it = webViewHandlers.find(view.Get());
+    if(it == webViewHandlers.end()) return V8Helpers::EventCallbackMap::Empty();
 
-    if(it != webViewHandlers.end())
-    {
-        auto range = it->second.equal_range(name);
-
-        for(auto it = range.first; it != range.second; ++it) handlers.push_back(&it->second);
-    }
-
-    return handlers;
+    return it->second.Get(name);
 }
 
-std::vector<V8Helpers::EventCallback*> CV8ResourceImpl::GetWebSocketClientHandlers(alt::Ref<alt::IWebSocketClient> webSocket, const std::string& name)
+const std::vector<V8Helpers::EventCallback*>& CV8ResourceImpl::GetWebSocketClientHandlers(alt::Ref<alt::IWebSocketClient> webSocket, const std::string& name)
 {
-    std::vector<V8Helpers::EventCallback*> handlers;
     auto it = webSocketClientHandlers.find(webSocket.Get());
+    if(it == webSocketClientHandlers.end()) return V8Helpers::EventCallbackMap::Empty();
 
-    if(it != webSocketClientHandlers.end())
-    {
-        auto range = it->second.equal_range(name);
-
-        for(auto it = range.first; it != range.second; ++it) handlers.push_back(&it->second);
-    }
-
-    return handlers;
+    return it->second.Get(name);
 }
 
-std::vector<V8Helpers::EventCallback*> CV8ResourceImpl::GetAudioHandlers(alt::Ref<alt::IAudio> audio, const std::string& name)
+const std::vector<V8Helpers::EventCallback*>& CV8ResourceImpl::GetAudioHandlers(alt::Ref<alt::IAudio> audio, const std::string& name)
 {
-    std::vector<V8Helpers::EventCallback*> handlers;
     auto it = audioHandlers.find(audio.Get());
+    if(it == audioHandlers.end()) return V8Helpers::EventCallbackMap::Empty();
 
-    if(it != audioHandlers.end())
-    {
-        auto range = it->second.equal_range(name);
-
-        for(auto it = range.first; it != range.second; ++it) handlers.push_back(&it->second);
-    }
-
-    return handlers;
+    return it->second.Get(name);
 }
 
-std::vector<V8Helpers::EventCallback*> CV8ResourceImpl::GetRmlHandlers(alt::Ref<alt::IRmlElement> element, const std::string& name)
+const std::vector<V8Helpers::EventCallback*>& CV8ResourceImpl::GetRmlHandlers(alt::Ref<alt::IRmlElement> element, const std::string& name)
 {
-    std::vector<V8Helpers::EventCallback*> handlers;
     auto it = rmlHandlers.find(element);
+    if(it == rmlHandlers.end()) return V8Helpers::EventCallbackMap::Empty();
 
-    if(it != rmlHandlers.end())
-    {
-        auto range = it->second.equal_range(name);
-
-        for(auto it = range.first; it != range.second; ++it) handlers.push_back(&it->second);
-    }
-
-    return handlers;
+    return it->second.Get(name);
 }
 
 void CV8ResourceImpl::OnTick()
@@ -401,44 +402,12 @@ void CV8ResourceImpl::OnTick()
         Log::Warning << "Resource " << resource->GetName() << " tick was too long " << GetTime() - time << " ms" << Log::Endl;
     }
 
-    for(auto& view : webViewHandlers)
-    {
-        for(auto it = view.second.begin(); it != view.second.end();)
-        {
-            if(it->second.removed) it = view.second.erase(it);
-            else
-                ++it;
-        }
-    }
-
-    for(auto& webSocket : webSocketClientHandlers)
-    {
-        for(auto it = webSocket.second.begin(); it != webSocket.second.end();)
-        {
-            if(it->second.removed) it = webSocket.second.erase(it);
-            else
-                ++it;
-        }
-    }
-
-    for(auto& audio : audioHandlers)
-    {
-        for(auto it = audio.second.begin(); it != audio.second.end();)
-        {
-            if(it->second.removed) it = audio.second.erase(it);
-            else
-                ++it;
-        }
-    }
-
-    for(auto& rml : rmlHandlers)
+    if(eventDispatchDepth == 0)
     {
-        for(auto it = rml.second.begin(); it != rml.second.end();)
-        {
-            if(it->second.removed) it = rml.second.erase(it);
-            else
-                ++it;
-        }
+        for(auto& view : webViewHandlers) view.second.RemoveMarked();
+        for(auto& webSocket : webSocketClientHandlers) webSocket.second.RemoveMarked();
+        for(auto& audio : audioHandlers) audio.second.RemoveMarked();
+        for(auto& rml : rmlHandlers) rml.second.RemoveMarked();
     }
 
     for(auto worker : workers)
@@ -446,6 +415,7 @@ void CV8ResourceImpl::OnTick()
         worker->GetMainEventHandler().Process();
     }
 
+    assetRequests.ProcessQueue(this);
     promiseRejections.ProcessQueue(this);
 }
 
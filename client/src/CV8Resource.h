@@ -6,6 +6,7 @@
 #include "V8ResourceImpl.h"
 #include "IImportHandler.h"
 #include "PromiseRejections.h"
+#include "AssetRequests.h"
 
 #include <queue>
 
@@ -37,93 +38,62 @@ public:
     void OnPromiseRejectedWithNoHandler(v8::PromiseRejectMessage& data);
     void OnPromiseHandlerAdded(v8::PromiseRejectMessage& data);
 
+    V8Helpers::AssetRequests& GetAssetRequests()
+    {
+        return assetRequests;
+    }
+
     void SubscribeWebView(alt::Ref<alt::IWebView> view, const std::string& evName, v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location, bool once = false)
     {
-        webViewHandlers[view].insert({ evName, V8Helpers::EventCallback{ isolate, cb, std::move(location), once } });
+        webViewHandlers[view].Add(evName, new V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
     }
 
     void UnsubscribeWebView(alt::Ref<alt::IWebView> view, const std::string& evName, v8::Local<v8::Function> cb)
     {
         auto it = webViewHandlers.find(view);
-        if(it != webViewHandlers.end())
-        {
-            auto& viewEvents = it->second;
-            auto range = viewEvents.equal_range(evName);
-
-            for(auto it = range.first; it != range.second; ++it)
-            {
-                if(it->second.fn.Get(isolate)->StrictEquals(cb)) it->second.removed = true;
-            }
-        }
+        if(it != webViewHandlers.end()) it->second.Remove(isolate, evName, cb);
     }
 
-    std::vector<V8Helpers::EventCallback*> GetWebViewHandlers(alt::Ref<alt::IWebView> view, const std::string& name);
+    const std::vector<V8Helpers::EventCallback*>& GetWebViewHandlers(alt::Ref<alt::IWebView> view, const std::string& name);
 
     void SubscribeWebSocketClient(alt::Ref<alt::IWebSocketClient> webSocket, const std::string& evName, v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location)
     {
-        webSocketClientHandlers[webSocket].insert({ evName, V8Helpers::EventCallback{ isolate, cb, std::move(location) } });
+        webSocketClientHandlers[webSocket].Add(evName, new V8Helpers::EventCallback{ isolate, cb, std::move(location) });
     }
 
     void UnsubscribeWebSocketClient(alt::Ref<alt::IWebSocketClient> webSocket, const std::string& evName, v8::Local<v8::Function> cb)
     {
         auto it = webSocketClientHandlers.find(webSocket);
-        if(it != webSocketClientHandlers.end())
-        {
-            auto& webSocketEvents = it->second;
-            auto range = webSocketEvents.equal_range(evName);
-
-            for(auto it = range.first; it != range.second; ++it)
-            {
-                if(it->second.fn.Get(isolate)->StrictEquals(cb)) it->second.removed = true;
-            }
-        }
+        if(it != webSocketClientHandlers.end()) it->second.Remove(isolate, evName, cb);
     }
 
-    std::vector<V8Helpers::EventCallback*> GetWebSocketClientHandlers(alt::Ref<alt::IWebSocketClient> webSocket, const std::string& name);
+    const std::vector<V8Helpers::EventCallback*>& GetWebSocketClientHandlers(alt::Ref<alt::IWebSocketClient> webSocket, const std::string& name);
 
     void SubscribeAudio(alt::Ref<alt::IAudio> audio, const std::string& evName, v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location)
     {
-        audioHandlers[audio].insert({ evName, V8Helpers::EventCallback{ isolate, cb, std::move(location) } });
+        audioHandlers[audio].Add(evName, new V8Helpers::EventCallback{ isolate, cb, std::move(location) });
     }
 
     void UnsubscribeAudio(alt::Ref<alt::IAudio> audio, const std::string& evName, v8::Local<v8::Function> cb)
     {
         auto it = audioHandlers.find(audio);
-        if(it != audioHandlers.end())
-        {
-            auto& audioEvents = it->second;
-            auto range = audioEvents.equal_range(evName);
-
-            for(auto it = range.first; it != range.second; ++it)
-            {
-                if(it->second.fn.Get(isolate)->StrictEquals(cb)) it->second.removed = true;
-            }
-        }
+        if(it != audioHandlers.end()) it->second.Remove(isolate, evName, cb);
     }
 
-    std::vector<V8Helpers::EventCallback*> GetAudioHandlers(alt::Ref<alt::IAudio> audio, const std::string& name);
+    const std::vector<V8Helpers::EventCallback*>& GetAudioHandlers(alt::Ref<alt::IAudio> audio, const std::string& name);
 
     void SubscribeRml(alt::Ref<alt::IRmlElement> element, const std::string& evName, v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location)
     {
-        rmlHandlers[element].insert({ evName, V8Helpers::EventCallback{ isolate, cb, std::move(location) } });
+        rmlHandlers[element].Add(evName, new V8Helpers::EventCallback{ isolate, cb, std::move(location) });
     }
 
     void UnsubscribeRml(alt::Ref<alt::IRmlElement> element, const std::string& evName, v8::Local<v8::Function> cb)
     {
         auto it = rmlHandlers.find(element);
-        if(it != rmlHandlers.end())
-        {
-            auto& rmlEvents = it->second;
-            auto range = rmlEvents.equal_range(evName);
-
-            for(auto it = range.first; it != range.second; ++it)
-            {
-                if(it->second.fn.Get(isolate)->StrictEquals(cb)) it->second.removed = true;
-            }
-        }
+        if(it != rmlHandlers.end()) it->second.Remove(isolate, evName, cb);
     }
 
-    std::vector<V8Helpers::EventCallback*> GetRmlHandlers(alt::Ref<alt::IRmlElement> element, const std::string& name);
+    const std::vector<V8Helpers::EventCallback*>& GetRmlHandlers(alt::Ref<alt::IRmlElement> element, const std::string& name);
 
     void AddOwned(alt::Ref<alt::IBaseObject> handle)
     {
@@ -177,7 +147,7 @@ public:
 private:
     friend class CV8ScriptRuntime;
 
-    using EventHandlerMap = std::unordered_multimap<std::string, V8Helpers::EventCallback>;
+    using EventHandlerMap = V8Helpers::EventCallbackMap;
     using WebViewsEventsQueue = std::unordered_map<alt::Ref<alt::IWebView>, std::vector<std::pair<std::string, alt::MValueArgs>>>;
 
     std::unordered_map<alt::Ref<alt::IWebView>, EventHandlerMap> webViewHandlers;
@@ -203,6 +173,7 @@ private:
     std::list<std::function<void()>> dynamicImports;
 
     V8Helpers::PromiseRejections promiseRejections;
+    V8Helpers::AssetRequests assetRequests;
 
     // Key = Module identity hash, Value = Export value
     std::unordered_map<int, V8Helpers::CPersistent<v8::Value>> syntheticModuleExports;
@@ -5,6 +5,9 @@
 #include "V8Module.h"
 #include "events/Events.h"
 #include "CProfiler.h"
+#include "CTracer.h"
+#include "CWatchdog.h"
+#include "CCodeCache.h"
 
 CV8ScriptRuntime::CV8ScriptRuntime()
 {
@@ -193,6 +196,9 @@ CV8ScriptRuntime::CV8ScriptRuntime()
     // IsWorker data slot
     isolate->SetData(v8::Isolate::GetNumberOfDataSlots() - 1, new bool(false));
 
+    // Options like weak entities change how the class templates are built
+    ProcessConfigOptions();
+
     {
         v8::Locker locker(isolate);
         v8::Isolate::Scope isolate_scope(isolate);
@@ -206,7 +212,8 @@ CV8ScriptRuntime::CV8ScriptRuntime()
 
     RegisterEvents();
 
-    ProcessConfigOptions();
+    CCodeCache::Instance().SetDirectory((alt::ICore::Instance().GetClientPath() + "/cache/js-module").ToString());
+    CCodeCache::Instance().Trim();
 }
 
 void CV8ScriptRuntime::ProcessConfigOptions()
@@ -227,6 +234,96 @@ void CV8ScriptRuntime::ProcessConfigOptions()
             Log::Error << "Invalid value for 'profiler' config option" << Log::Endl;
         }
     }
+
+    alt::config::Node tracer = moduleConfig["tracer"];
+    if(!tracer.IsNone())
+    {
+        try
+        {
+            bool result = tracer.ToBool();
+            CTracer::Instance().SetIsEnabled(result);
+            if(result) CTracer::Instance().SetThreadName("Main");
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'tracer' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node codeCache = moduleConfig["code-cache"];
+    if(!codeCache.IsNone())
+    {
+        try
+        {
+            bool result = codeCache.ToBool();
+            CCodeCache::Instance().SetIsEnabled(result);
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'code-cache' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node sourceLocations = moduleConfig["source-locations"];
+    if(!sourceLocations.IsNone())
+    {
+        try
+        {
+            V8Helpers::SourceLocation::CaptureMode mode;
+            if(V8Helpers::SourceLocation::ParseCaptureMode(sourceLocations.ToString(), mode))
+            {
+                uint32_t sampleRate = 0;
+                alt::config::Node sampleRateNode = moduleConfig["source-locations-sample-rate"];
+                if(!sampleRateNode.IsNone()) sampleRate = (uint32_t)sampleRateNode.ToNumber();
+                V8Helpers::SourceLocation::SetCaptureMode(mode, sampleRate);
+            }
+            else
+                Log::Error << "Invalid value for 'source-locations' config option, expected 'off', 'sampled', 'lazy' or 'always'" << Log::Endl;
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'source-locations' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node executionTimeout = moduleConfig["execution-timeout"];
+    if(!executionTimeout.IsNone())
+    {
+        try
+        {
+            CWatchdog::Instance().SetDefaultTimeout((uint32_t)executionTimeout.ToNumber());
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'execution-timeout' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node weakEntities = moduleConfig["weak-entities"];
+    if(!weakEntities.IsNone())
+    {
+        try
+        {
+            V8Entity::SetWrappersWeak(weakEntities.ToBool());
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'weak-entities' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node asyncEventTimeout = moduleConfig["async-event-timeout"];
+    if(!asyncEventTimeout.IsNone())
+    {
+        try
+        {
+            V8ResourceImpl::SetAsyncEventTimeout((uint32_t)asyncEventTimeout.ToNumber());
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'async-event-timeout' config option" << Log::Endl;
+        }
+    }
 }
 
 void CV8ScriptRuntime::OnDispose()
@@ -238,6 +335,7 @@ void CV8ScriptRuntime::OnDispose()
     delete create_params.array_buffer_allocator;
 
     if(CProfiler::Instance().IsEnabled()) CProfiler::Instance().Dump(alt::ICore::Instance().GetClientPath().ToString());
+    if(CTracer::Instance().IsEnabled()) CTracer::Instance().Dump(alt::ICore::Instance().GetClientPath().ToString());
 
     CV8ScriptRuntime::SetInstance(nullptr);
     delete this;
@@ -1,5 +1,6 @@
 #include "IImportHandler.h"
 #include "V8Module.h"
+#include "CCodeCache.h"
 
 static inline v8::MaybeLocal<v8::Module> CompileESM(v8::Isolate* isolate, const std::string& name, const std::string& src)
 {
@@ -7,8 +8,30 @@ static inline v8::MaybeLocal<v8::Module> CompileESM(v8::Isolate* isolate, const
 
     v8::ScriptOrigin scriptOrigin(isolate, V8Helpers::JSValue(name), 0, 0, false, -1, v8::Local<v8::Value>(), false, false, true, v8::Local<v8::PrimitiveArray>());
 
-    v8::ScriptCompiler::Source source{ sourceCode, scriptOrigin };
-    return v8::ScriptCompiler::CompileModule(isolate, &source);
+    CCodeCache& codeCache = CCodeCache::Instance();
+    if(!codeCache.IsEnabled())
+    {
+        v8::ScriptCompiler::Source source{ sourceCode, scriptOrigin };
+        return v8::ScriptCompiler::CompileModule(isolate, &source);
+    }
+
+    std::string hash = CCodeCache::Hash(src);
+    v8::ScriptCompiler::CachedData* cachedData = codeCache.Load(hash, src.size());
+    v8::ScriptCompiler::Source source{ sourceCode, scriptOrigin, cachedData };
+    v8::MaybeLocal<v8::Module> maybeModule =
+      v8::ScriptCompiler::CompileModule(isolate, &source, cachedData ? v8::ScriptCompiler::kConsumeCodeCache : v8::ScriptCompiler::kNoCompileOptions);
+
+    v8::Local<v8::Module> module;
+    if(!maybeModule.ToLocal(&module)) return maybeModule;
+
+    // Cache doesn't exist yet or was created by a V8 with different flags
+    if(!cachedData || cachedData->rejected)
+    {
+        if(cachedData) codeCache.Remove(hash);
+        codeCache.Add(isolate, hash, src.size(), module);
+    }
+
+    return maybeModule;
 }
 
 static inline bool IsSystemModule(v8::Isolate* isolate, const std::string& name)
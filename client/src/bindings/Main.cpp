@@ -18,14 +18,14 @@ static void OnServer(const v8::FunctionCallbackInfo<v8::Value>& info)
     {
         V8_ARG_TO_FUNCTION(1, callback);
 
-        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::GetCurrent(isolate));
+        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::Capture(isolate));
     }
     else if(info.Length() == 2)
     {
         V8_ARG_TO_STRING(1, eventName);
         V8_ARG_TO_FUNCTION(2, callback);
 
-        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::GetCurrent(isolate));
+        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::Capture(isolate));
     }
 }
 
@@ -38,14 +38,14 @@ static void OnceServer(const v8::FunctionCallbackInfo<v8::Value>& info)
     {
         V8_ARG_TO_FUNCTION(1, callback);
 
-        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::Capture(isolate), true);
     }
     else if(info.Length() == 2)
     {
         V8_ARG_TO_STRING(1, eventName);
         V8_ARG_TO_FUNCTION(2, callback);
 
-        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::Capture(isolate), true);
     }
 }
 
@@ -96,6 +96,11 @@ static void StaticGetByScriptID(const v8::FunctionCallbackInfo<v8::Value>& info)
     V8_RETURN_BASE_OBJECT(alt::ICore::Instance().GetEntityByScriptGuid(scriptGuid).As<alt::IPlayer>());
 }
 
+static void StaticGetTransforms(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8Helpers::GetTransforms(info, alt::ICore::Instance().GetPlayers());
+}
+
 static void StaticGetByID(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT_RESOURCE();
@@ -122,6 +127,7 @@ extern V8Class v8Player("Player", v8Entity, [](v8::Local<v8::FunctionTemplate> t
     V8Helpers::SetMethod(isolate, tpl, "toString", ToString);
 
     V8Helpers::SetStaticMethod(isolate, tpl, "getByID", StaticGetByID);
+    V8Helpers::SetStaticMethod(isolate, tpl, "getTransforms", StaticGetTransforms);
     V8Helpers::SetStaticMethod(isolate, tpl, "getByScriptID", StaticGetByScriptID);
 
     V8Helpers::SetStaticAccessor(isolate, tpl, "all", &AllGetter);
@@ -4,11 +4,10 @@
 #include "Log.h"
 #include "V8ResourceImpl.h"
 
-static uint64_t pointers[32];
-static uint32_t pointersCount = 0;
-
-static uint32_t returnsCount = 1;
+#include <map>
+#include <memory>
 
+// Strings have to outlive the native call, text commands keep the pointer until the command is ended
 static char* SaveString(const char* str)
 {
     static char* stringValues[256] = { 0 };
@@ -23,23 +22,6 @@ static char* SaveString(const char* str)
     return _str;
 }
 
-template<class T>
-static T* SavePointer(T val)
-{
-    T* ptr = reinterpret_cast<T*>(&pointers[pointersCount++]);
-    *ptr = val;
-    return ptr;
-}
-
-template<>
-static alt::INative::Vector3* SavePointer(alt::INative::Vector3 val)
-{
-    alt::INative::Vector3* ptr = reinterpret_cast<alt::INative::Vector3*>(&pointers[pointersCount]);
-    pointersCount += 3;
-    *ptr = val;
-    return ptr;
-}
-
 static void* ToMemoryBuffer(v8::Local<v8::Value> val, v8::Local<v8::Context> ctx)
 {
     if(val->IsObject())
@@ -111,229 +93,292 @@ inline void ShowNativeArgMismatchErrorMsg(v8::Isolate* isolate, alt::INative* na
     resource->DispatchErrorEvent(errorMsg.str(), source.GetFileName(), source.GetLineNumber());
 }
 
-static void
-  PushArg(alt::Ref<alt::INative::Context> scrCtx, alt::INative* native, alt::INative::Type argType, v8::Isolate* isolate, V8ResourceImpl* resource, v8::Local<v8::Value> val, uint32_t idx)
+// Maximum amount of 64 bit slots the pointer arguments of a native can use, a vector3 uses 3 slots
+static constexpr uint32_t MaxPointerSlots = 32;
+
+// State of a single native call, lives on the stack of the invoker
+struct NativeCall
 {
-    using ArgType = alt::INative::Type;
+    v8::Isolate* isolate;
+    v8::Local<v8::Context> ctx;
+    alt::INative* native;
+    alt::INative::Context* scrCtx;
+    uint64_t pointers[MaxPointerSlots];
+};
 
-    v8::Local<v8::Context> v8Ctx = isolate->GetEnteredOrMicrotaskContext();
+using ArgPusher = void (*)(NativeCall& call, v8::Local<v8::Value> val, uint32_t idx, uint64_t* pointer);
+using PointerReader = v8::Local<v8::Value> (*)(NativeCall& call, const uint64_t* pointer);
+using ResultGetter = v8::Local<v8::Value> (*)(NativeCall& call);
 
-    switch(argType)
+template<class T>
+static void PushInteger(NativeCall& call, alt::INative::Type argType, v8::Local<v8::Value> val, uint32_t idx)
+{
+    if(val->IsNumber())
     {
-        case alt::INative::Type::ARG_BOOL: scrCtx->Push((int32_t)val->ToBoolean(isolate)->Value()); break;
-        case alt::INative::Type::ARG_BOOL_PTR:
-            ++returnsCount;
-            scrCtx->Push(SavePointer((int32_t)val->ToBoolean(isolate)->Value()));
-            break;
-        case alt::INative::Type::ARG_INT32:
+        v8::Local<v8::Integer> value;
+        if(val->ToInteger(call.ctx).ToLocal(&value))
         {
-            if(val->IsNumber())
-            {
-                v8::Local<v8::Integer> value;
-                if(val->ToInteger(v8Ctx).ToLocal(&value))
-                {
-                    scrCtx->Push((int32_t)value->Value());
-                }
-                else
-                {
-                    ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                    scrCtx->Push(0);
-                }
-            }
-            else if(val->IsBigInt())
-            {
-                v8::Local<v8::BigInt> value;
-                if(val->ToBigInt(v8Ctx).ToLocal(&value))
-                {
-                    scrCtx->Push((int32_t)value->Int64Value());
-                }
-                else
-                {
-                    ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                    scrCtx->Push(0);
-                }
-            }
-            else if(val->IsObject())
-            {
-                auto ent = V8Entity::Get(val);
-                if(ent != nullptr) scrCtx->Push(ent->GetHandle().As<alt::IEntity>()->GetScriptGuid());
-                else
-                    scrCtx->Push(0);
-            }
-            else
-            {
-                ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                scrCtx->Push(0);
-            }
-            break;
+            call.scrCtx->Push((T)value->Value());
+            return;
         }
-        case alt::INative::Type::ARG_INT32_PTR:
-            ++returnsCount;
-            scrCtx->Push(SavePointer((int32_t)val->ToInteger(v8Ctx).ToLocalChecked()->Value()));
-            break;
-        case alt::INative::Type::ARG_UINT32:
+    }
+    else if(val->IsBigInt())
+    {
+        v8::Local<v8::BigInt> value;
+        if(val->ToBigInt(call.ctx).ToLocal(&value))
         {
-            if(val->IsNumber())
-            {
-                v8::Local<v8::Integer> value;
-                if(val->ToInteger(v8Ctx).ToLocal(&value))
-                {
-                    scrCtx->Push((uint32_t)value->Value());
-                }
-                else
-                {
-                    ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                    scrCtx->Push(0);
-                }
-            }
-            else if(val->IsBigInt())
-            {
-                v8::Local<v8::BigInt> value;
-                if(val->ToBigInt(v8Ctx).ToLocal(&value))
-                {
-                    scrCtx->Push((uint32_t)value->Int64Value());
-                }
-                else
-                {
-                    ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                    scrCtx->Push(0);
-                }
-            }
-            else
-            {
-                ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                scrCtx->Push(0);
-            }
-            break;
+            call.scrCtx->Push((T)value->Int64Value());
+            return;
         }
-        case alt::INative::Type::ARG_UINT32_PTR:
-            ++returnsCount;
-            scrCtx->Push(SavePointer((uint32_t)val->ToInteger(v8Ctx).ToLocalChecked()->Value()));
-            break;
-        case alt::INative::Type::ARG_FLOAT:
+    }
+    else if(std::is_same_v<T, int32_t> && val->IsObject())
+    {
+        auto ent = V8Entity::Get(val);
+        if(ent != nullptr) call.scrCtx->Push(ent->GetHandle().As<alt::IEntity>()->GetScriptGuid());
+        else
+            call.scrCtx->Push(0);
+        return;
+    }
+
+    ShowNativeArgParseErrorMsg(call.isolate, val, call.native, argType, idx);
+    call.scrCtx->Push(0);
+}
+
+template<alt::INative::Type ArgType>
+static void PushArg(NativeCall& call, v8::Local<v8::Value> val, uint32_t idx, uint64_t* pointer)
+{
+    using Type = alt::INative::Type;
+
+    if constexpr(ArgType == Type::ARG_BOOL) call.scrCtx->Push((int32_t)val->ToBoolean(call.isolate)->Value());
+    else if constexpr(ArgType == Type::ARG_BOOL_PTR)
+    {
+        int32_t* ptr = reinterpret_cast<int32_t*>(pointer);
+        *ptr = (int32_t)val->ToBoolean(call.isolate)->Value();
+        call.scrCtx->Push(ptr);
+    }
+    else if constexpr(ArgType == Type::ARG_INT32)
+        PushInteger<int32_t>(call, ArgType, val, idx);
+    else if constexpr(ArgType == Type::ARG_INT32_PTR)
+    {
+        int32_t* ptr = reinterpret_cast<int32_t*>(pointer);
+        *ptr = (int32_t)val->ToInteger(call.ctx).ToLocalChecked()->Value();
+        call.scrCtx->Push(ptr);
+    }
+    else if constexpr(ArgType == Type::ARG_UINT32)
+        PushInteger<uint32_t>(call, ArgType, val, idx);
+    else if constexpr(ArgType == Type::ARG_UINT32_PTR)
+    {
+        uint32_t* ptr = reinterpret_cast<uint32_t*>(pointer);
+        *ptr = (uint32_t)val->ToInteger(call.ctx).ToLocalChecked()->Value();
+        call.scrCtx->Push(ptr);
+    }
+    else if constexpr(ArgType == Type::ARG_FLOAT)
+    {
+        v8::Local<v8::Number> value;
+        if(val->IsNumber() && val->ToNumber(call.ctx).ToLocal(&value)) call.scrCtx->Push((float)value->Value());
+        else
         {
-            if(val->IsNumber())
-            {
-                v8::Local<v8::Number> value;
-                if(val->ToNumber(v8Ctx).ToLocal(&value))
-                {
-                    scrCtx->Push((float)value->Value());
-                }
-                else
-                {
-                    ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                    scrCtx->Push(0.f);
-                }
-            }
-            else
-            {
-                ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                scrCtx->Push(0.f);
-            }
-            break;
+            ShowNativeArgParseErrorMsg(call.isolate, val, call.native, ArgType, idx);
+            call.scrCtx->Push(0.f);
         }
-        case alt::INative::Type::ARG_FLOAT_PTR:
-            ++returnsCount;
-            scrCtx->Push(SavePointer((float)val->ToNumber(v8Ctx).ToLocalChecked()->Value()));
-            break;
-        case alt::INative::Type::ARG_VECTOR3_PTR:
-            ++returnsCount;
-            scrCtx->Push(SavePointer(alt::INative::Vector3{}));  // TODO: Add initializer
-            break;
-        case alt::INative::Type::ARG_STRING:
-            if(val->IsString()) scrCtx->Push(SaveString(*v8::String::Utf8Value(isolate, val->ToString(v8Ctx).ToLocalChecked())));
-            else
-                scrCtx->Push((char*)nullptr);
-            break;
-        case alt::INative::Type::ARG_STRUCT:
+    }
+    else if constexpr(ArgType == Type::ARG_FLOAT_PTR)
+    {
+        float* ptr = reinterpret_cast<float*>(pointer);
+        *ptr = (float)val->ToNumber(call.ctx).ToLocalChecked()->Value();
+        call.scrCtx->Push(ptr);
+    }
+    else if constexpr(ArgType == Type::ARG_VECTOR3_PTR)
+    {
+        alt::INative::Vector3* ptr = reinterpret_cast<alt::INative::Vector3*>(pointer);
+        *ptr = alt::INative::Vector3{};  // TODO: Add initializer
+        call.scrCtx->Push(ptr);
+    }
+    else if constexpr(ArgType == Type::ARG_STRING)
+    {
+        if(val->IsString()) call.scrCtx->Push(SaveString(*v8::String::Utf8Value(call.isolate, val)));
+        else
+            call.scrCtx->Push((char*)nullptr);
+    }
+    else if constexpr(ArgType == Type::ARG_STRUCT)
+    {
+        auto buffer = ToMemoryBuffer(val, call.ctx);
+        if(buffer != nullptr) call.scrCtx->Push(buffer);
+        else
         {
-            auto buffer = ToMemoryBuffer(val, v8Ctx);
-            if(buffer != nullptr) scrCtx->Push(buffer);
-            else
-            {
-                ShowNativeArgParseErrorMsg(isolate, val, native, argType, idx);
-                scrCtx->Push((void*)nullptr);
-            }
-            break;
+            ShowNativeArgParseErrorMsg(call.isolate, val, call.native, ArgType, idx);
+            call.scrCtx->Push((void*)nullptr);
         }
-        default: Log::Error << "Unknown native arg type " << (int)argType << " (" << native->GetName() << ")" << Log::Endl;
     }
 }
 
-static void PushPointerReturn(alt::INative::Type argType, v8::Local<v8::Array> retns, v8::Isolate* isolate, v8::Local<v8::Context> ctx)
+static void PushUnknownArg(NativeCall& call, v8::Local<v8::Value>, uint32_t idx, uint64_t*)
 {
-    using ArgType = alt::INative::Type;
+    Log::Error << "Unknown native arg type " << (int)call.native->GetArgTypes()[idx] << " (" << call.native->GetName() << ")" << Log::Endl;
+}
 
-    switch(argType)
+template<alt::INative::Type ArgType>
+static v8::Local<v8::Value> ReadPointer(NativeCall& call, const uint64_t* pointer)
+{
+    using Type = alt::INative::Type;
+
+    if constexpr(ArgType == Type::ARG_BOOL_PTR || ArgType == Type::ARG_INT32_PTR) return V8Helpers::JSValue(*reinterpret_cast<const int32_t*>(pointer));
+    else if constexpr(ArgType == Type::ARG_UINT32_PTR)
+        return V8Helpers::JSValue(*reinterpret_cast<const uint32_t*>(pointer));
+    else if constexpr(ArgType == Type::ARG_FLOAT_PTR)
+        return V8Helpers::JSValue(*reinterpret_cast<const float*>(pointer));
+    else
     {
-        case alt::INative::Type::ARG_BOOL_PTR: retns->Set(ctx, returnsCount++, V8Helpers::JSValue(*reinterpret_cast<int32_t*>(&pointers[pointersCount++]))); break;
-        case alt::INative::Type::ARG_INT32_PTR: retns->Set(ctx, returnsCount++, V8Helpers::JSValue(*reinterpret_cast<int32_t*>(&pointers[pointersCount++]))); break;
-        case alt::INative::Type::ARG_UINT32_PTR: retns->Set(ctx, returnsCount++, V8Helpers::JSValue(*reinterpret_cast<uint32_t*>(&pointers[pointersCount++]))); break;
-        case alt::INative::Type::ARG_FLOAT_PTR: retns->Set(ctx, returnsCount++, V8Helpers::JSValue(*reinterpret_cast<float*>(&pointers[pointersCount++]))); break;
-        case alt::INative::Type::ARG_VECTOR3_PTR:
-        {
-            alt::INative::Vector3* val = reinterpret_cast<alt::INative::Vector3*>(&pointers[pointersCount]);
-            pointersCount += 3;
+        const alt::INative::Vector3* val = reinterpret_cast<const alt::INative::Vector3*>(pointer);
+        return V8ResourceImpl::Get(call.ctx)->CreateVector3({ val->x, val->y, val->z });
+    }
+}
 
-            v8::Local<v8::Context> v8Ctx = isolate->GetEnteredOrMicrotaskContext();
-            V8ResourceImpl* resource = V8ResourceImpl::Get(v8Ctx);
-            auto vector = resource->CreateVector3({ val->x, val->y, val->z }).As<v8::Object>();
+template<alt::INative::Type RetnType>
+static v8::Local<v8::Value> GetResult(NativeCall& call)
+{
+    using Type = alt::INative::Type;
 
-            retns->Set(ctx, returnsCount++, vector);
-            break;
-        }
+    if constexpr(RetnType == Type::ARG_BOOL) return V8Helpers::JSValue(call.scrCtx->ResultBool());
+    else if constexpr(RetnType == Type::ARG_INT32)
+        return V8Helpers::JSValue(call.scrCtx->ResultInt());
+    else if constexpr(RetnType == Type::ARG_UINT32)
+        return V8Helpers::JSValue(call.scrCtx->ResultUint());
+    else if constexpr(RetnType == Type::ARG_FLOAT)
+        return V8Helpers::JSValue(call.scrCtx->ResultFloat());
+    else if constexpr(RetnType == Type::ARG_VECTOR3)
+    {
+        alt::INative::Vector3 val = call.scrCtx->ResultVector3();
+        return V8ResourceImpl::Get(call.ctx)->CreateVector3({ val.x, val.y, val.z });
+    }
+    else if constexpr(RetnType == Type::ARG_STRING)
+    {
+        const char* str = call.scrCtx->ResultString();
+        if(!str) return V8Helpers::JSValue(nullptr);
+        return V8Helpers::JSValue(str);
     }
+    else
+        return v8::Undefined(call.isolate);
 }
 
-static v8::Local<v8::Value> GetReturn(alt::Ref<alt::INative::Context> scrCtx, alt::INative* native, alt::INative::Type retnType, v8::Isolate* isolate)
+static v8::Local<v8::Value> GetUnknownResult(NativeCall& call)
 {
-    using ArgType = alt::INative::Type;
+    Log::Error << "Unknown native return type " << (int)call.native->GetRetnType() << " (" << call.native->GetName() << ")" << Log::Endl;
+    return v8::Undefined(call.isolate);
+}
 
-    v8::Local<v8::Context> v8Ctx = isolate->GetEnteredOrMicrotaskContext();
+// Everything about a native signature that can be resolved once when the natives are registered
+struct NativeSignature
+{
+    struct Arg
+    {
+        ArgPusher push;
+        // Only set for pointer arguments, their values are returned after the call
+        PointerReader read = nullptr;
+        uint32_t pointerOffset = 0;
+    };
+
+    std::vector<Arg> args;
+    ResultGetter result;
+    // Arguments that have to be passed from JS, pointer and void arguments are optional
+    int neededArgs = 0;
+    uint32_t pointerSlots = 0;
+    uint32_t pointerArgs = 0;
+};
+
+static NativeSignature::Arg GetArgThunks(alt::INative::Type argType)
+{
+    using Type = alt::INative::Type;
+    switch(argType)
+    {
+        case Type::ARG_BOOL: return { &PushArg<Type::ARG_BOOL> };
+        case Type::ARG_BOOL_PTR: return { &PushArg<Type::ARG_BOOL_PTR>, &ReadPointer<Type::ARG_BOOL_PTR> };
+        case Type::ARG_INT32: return { &PushArg<Type::ARG_INT32> };
+        case Type::ARG_INT32_PTR: return { &PushArg<Type::ARG_INT32_PTR>, &ReadPointer<Type::ARG_INT32_PTR> };
+        case Type::ARG_UINT32: return { &PushArg<Type::ARG_UINT32> };
+        case Type::ARG_UINT32_PTR: return { &PushArg<Type::ARG_UINT32_PTR>, &ReadPointer<Type::ARG_UINT32_PTR> };
+        case Type::ARG_FLOAT: return { &PushArg<Type::ARG_FLOAT> };
+        case Type::ARG_FLOAT_PTR: return { &PushArg<Type::ARG_FLOAT_PTR>, &ReadPointer<Type::ARG_FLOAT_PTR> };
+        case Type::ARG_VECTOR3_PTR: return { &PushArg<Type::ARG_VECTOR3_PTR>, &ReadPointer<Type::ARG_VECTOR3_PTR> };
+        case Type::ARG_STRING: return { &PushArg<Type::ARG_STRING> };
+        case Type::ARG_STRUCT: return { &PushArg<Type::ARG_STRUCT> };
+        default: return { &PushUnknownArg };
+    }
+}
 
+static ResultGetter GetResultThunk(alt::INative::Type retnType)
+{
+    using Type = alt::INative::Type;
     switch(retnType)
     {
-        case alt::INative::Type::ARG_BOOL: return V8Helpers::JSValue(scrCtx->ResultBool());
-        case alt::INative::Type::ARG_INT32: return V8Helpers::JSValue(scrCtx->ResultInt());
-        case alt::INative::Type::ARG_UINT32: return V8Helpers::JSValue(scrCtx->ResultUint());
-        case alt::INative::Type::ARG_FLOAT: return V8Helpers::JSValue(scrCtx->ResultFloat());
-        case alt::INative::Type::ARG_VECTOR3:
-        {
-            alt::INative::Vector3 val = scrCtx->ResultVector3();
-            V8ResourceImpl* resource = V8ResourceImpl::Get(v8Ctx);
-            auto vector = resource->CreateVector3({ val.x, val.y, val.z }).As<v8::Object>();
-            return vector;
-        }
-        case alt::INative::Type::ARG_STRING:
-            if(!scrCtx->ResultString()) return V8Helpers::JSValue(nullptr);
-            return V8Helpers::JSValue(scrCtx->ResultString());
-        case alt::INative::Type::ARG_VOID: return v8::Undefined(isolate);
-        default: Log::Error << "Unknown native return type " << (int)retnType << " (" << native->GetName() << ")" << Log::Endl; return v8::Undefined(isolate);
+        case Type::ARG_BOOL: return &GetResult<Type::ARG_BOOL>;
+        case Type::ARG_INT32: return &GetResult<Type::ARG_INT32>;
+        case Type::ARG_UINT32: return &GetResult<Type::ARG_UINT32>;
+        case Type::ARG_FLOAT: return &GetResult<Type::ARG_FLOAT>;
+        case Type::ARG_VECTOR3: return &GetResult<Type::ARG_VECTOR3>;
+        case Type::ARG_STRING: return &GetResult<Type::ARG_STRING>;
+        case Type::ARG_VOID: return &GetResult<Type::ARG_VOID>;
+        default: return &GetUnknownResult;
     }
 }
 
-static inline int GetNativeNeededArgCount(alt::INative* native)
+// Returns the shared invoker data for the signature of the native, or nullptr if the signature is not supported
+static const NativeSignature* GetSignature(alt::INative* native)
 {
-    int count = 0;
-    auto args = native->GetArgTypes();
-    for(auto arg : args)
+    using Type = alt::INative::Type;
+    // Natives are the same for every resource, so the signatures are only built once
+    static std::map<std::vector<Type>, std::unique_ptr<NativeSignature>> signatures;
+
+    auto argTypes = native->GetArgTypes();
+    // Last entry is the return type
+    std::vector<Type> key;
+    key.reserve(argTypes.GetSize() + 1);
+    for(auto argType : argTypes) key.push_back(argType);
+    key.push_back(native->GetRetnType());
+
+    auto it = signatures.find(key);
+    if(it != signatures.end()) return it->second.get();
+
+    auto signature = std::make_unique<NativeSignature>();
+    signature->args.reserve(argTypes.GetSize());
+    signature->result = GetResultThunk(native->GetRetnType());
+    for(auto argType : argTypes)
+    {
+        NativeSignature::Arg arg = GetArgThunks(argType);
+        if(arg.read)
+        {
+            arg.pointerOffset = signature->pointerSlots;
+            signature->pointerSlots += argType == Type::ARG_VECTOR3_PTR ? 3 : 1;
+            signature->pointerArgs++;
+        }
+        else if(argType != Type::ARG_VOID)
+            signature->neededArgs++;
+        signature->args.push_back(arg);
+    }
+
+    if(signature->pointerSlots > MaxPointerSlots)
     {
-        if(arg == alt::INative::Type::ARG_BOOL_PTR || arg == alt::INative::Type::ARG_INT32_PTR || arg == alt::INative::Type::ARG_UINT32_PTR || arg == alt::INative::Type::ARG_FLOAT_PTR ||
-           arg == alt::INative::Type::ARG_VOID || arg == alt::INative::Type::ARG_VECTOR3_PTR)
-            continue;
-        count++;
+        Log::Error << "Native " << native->GetName() << " has too many pointer arguments" << Log::Endl;
+        signature.reset();
     }
-    return count;
+
+    return signatures.emplace(std::move(key), std::move(signature)).first->second.get();
 }
 
+struct NativeBinding
+{
+    alt::INative* native;
+    const NativeSignature* signature;
+};
+
 static void InvokeNative(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     static auto ctx = alt::ICore::Instance().CreateNativesContext();
 
     v8::Isolate* isolate = info.GetIsolate();
-    v8::Local<v8::Context> v8Ctx = isolate->GetCurrentContext();
-
-    auto native = static_cast<alt::INative*>(info.Data().As<v8::External>()->Value());
+    auto binding = static_cast<NativeBinding*>(info.Data().As<v8::External>()->Value());
+    alt::INative* native = binding->native;
+    const NativeSignature* signature = binding->signature;
 
     if(!native->IsValid())
     {
@@ -341,22 +386,21 @@ static void InvokeNative(const v8::FunctionCallbackInfo<v8::Value>& info)
         return;
     }
 
-    auto args = native->GetArgTypes();
-    uint32_t argsSize = args.GetSize();
-
-    auto neededArgs = GetNativeNeededArgCount(native);
-    if(neededArgs > info.Length())
+    if(signature->neededArgs > info.Length())
     {
-        ShowNativeArgMismatchErrorMsg(isolate, native, neededArgs, info.Length());
+        ShowNativeArgMismatchErrorMsg(isolate, native, signature->neededArgs, info.Length());
         return;
     }
 
-    ctx->Reset();
-    pointersCount = 0;
-    returnsCount = 1;
+    NativeCall call{ isolate, isolate->GetCurrentContext(), native, ctx.Get() };
 
-    auto resource = V8ResourceImpl::Get(v8Ctx);
-    for(uint32_t i = 0; i < argsSize; ++i) PushArg(ctx, native, args[i], isolate, resource, info[i], i);
+    ctx->Reset();
+    uint32_t argsSize = (uint32_t)signature->args.size();
+    for(uint32_t i = 0; i < argsSize; ++i)
+    {
+        const NativeSignature::Arg& arg = signature->args[i];
+        arg.push(call, info[i], i, call.pointers + arg.pointerOffset);
+    }
 
     if(!native->Invoke(ctx))
     {
@@ -364,31 +408,37 @@ static void InvokeNative(const v8::FunctionCallbackInfo<v8::Value>& info)
         return;
     }
 
-    if(returnsCount == 1)
+    if(signature->pointerArgs == 0)
     {
-        info.GetReturnValue().Set(GetReturn(ctx, native, native->GetRetnType(), isolate));
+        info.GetReturnValue().Set(signature->result(call));
+        return;
     }
-    else
-    {
-        v8::Local<v8::Array> retns = v8::Array::New(isolate, returnsCount);
-        retns->Set(v8Ctx, 0, GetReturn(ctx, native, native->GetRetnType(), isolate));
-
-        pointersCount = 0;
-        returnsCount = 1;
 
-        for(uint32_t i = 0; i < argsSize; ++i) PushPointerReturn(args[i], retns, isolate, v8Ctx);
+    v8::Local<v8::Array> retns = v8::Array::New(isolate, signature->pointerArgs + 1);
+    retns->Set(call.ctx, 0, signature->result(call));
 
-        info.GetReturnValue().Set(retns);
+    uint32_t returnsCount = 1;
+    for(const NativeSignature::Arg& arg : signature->args)
+    {
+        if(arg.read) retns->Set(call.ctx, returnsCount++, arg.read(call, call.pointers + arg.pointerOffset));
     }
+
+    info.GetReturnValue().Set(retns);
 }
 
 static void RegisterNatives(v8::Local<v8::Context> ctx, v8::Local<v8::Object> exports)
 {
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    // Shared by all resources, the natives never change while the client is running
+    static std::unordered_map<alt::INative*, NativeBinding> bindings;
 
     for(auto native : alt::ICore::Instance().GetAllNatives())
     {
-        V8Helpers::SetFunction(isolate, ctx, exports, native->GetName().CStr(), InvokeNative, native);
+        auto it = bindings.find(native);
+        if(it == bindings.end()) it = bindings.emplace(native, NativeBinding{ native, GetSignature(native) }).first;
+        if(!it->second.signature) continue;
+
+        V8Helpers::SetFunction(isolate, ctx, exports, native->GetName().CStr(), InvokeNative, &it->second);
     }
 }
 
@@ -93,6 +93,11 @@ static void StaticGetByScriptID(const v8::FunctionCallbackInfo<v8::Value>& info)
     V8_RETURN_BASE_OBJECT(alt::ICore::Instance().GetEntityByScriptGuid(scriptGuid).As<alt::IVehicle>());
 }
 
+static void StaticGetTransforms(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8Helpers::GetTransforms(info, alt::ICore::Instance().GetVehicles());
+}
+
 static void StaticGetByID(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT_RESOURCE();
@@ -136,6 +141,7 @@ extern V8Class v8Vehicle("Vehicle", v8Entity, [](v8::Local<v8::FunctionTemplate>
     V8Helpers::SetMethod(isolate, tpl, "toString", ToString);
 
     V8Helpers::SetStaticMethod(isolate, tpl, "getByID", StaticGetByID);
+    V8Helpers::SetStaticMethod(isolate, tpl, "getTransforms", StaticGetTransforms);
     V8Helpers::SetStaticMethod(isolate, tpl, "getByScriptID", StaticGetByScriptID);
 
     V8Helpers::SetStaticAccessor(isolate, tpl, "all", &AllGetter);
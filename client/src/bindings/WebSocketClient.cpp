@@ -36,7 +36,7 @@ static void On(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     V8_GET_THIS_BASE_OBJECT(webSocket, alt::IWebSocketClient);
 
-    static_cast<CV8ResourceImpl*>(resource)->SubscribeWebSocketClient(webSocket, evName.ToString(), fun, V8Helpers::SourceLocation::GetCurrent(isolate));
+    static_cast<CV8ResourceImpl*>(resource)->SubscribeWebSocketClient(webSocket, evName.ToString(), fun, V8Helpers::SourceLocation::Capture(isolate));
 }
 
 static void Off(const v8::FunctionCallbackInfo<v8::Value>& info)
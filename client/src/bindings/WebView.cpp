@@ -32,7 +32,7 @@ static void On(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     V8_GET_THIS_BASE_OBJECT(view, alt::IWebView);
 
-    static_cast<CV8ResourceImpl*>(resource)->SubscribeWebView(view, evName.ToString(), fun, V8Helpers::SourceLocation::GetCurrent(isolate));
+    static_cast<CV8ResourceImpl*>(resource)->SubscribeWebView(view, evName.ToString(), fun, V8Helpers::SourceLocation::Capture(isolate));
 }
 
 static void Once(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -45,7 +45,7 @@ static void Once(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     V8_GET_THIS_BASE_OBJECT(view, alt::IWebView);
 
-    static_cast<CV8ResourceImpl*>(resource)->SubscribeWebView(view, evName.ToString(), fun, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+    static_cast<CV8ResourceImpl*>(resource)->SubscribeWebView(view, evName.ToString(), fun, V8Helpers::SourceLocation::Capture(isolate), true);
 }
 
 static void Off(const v8::FunctionCallbackInfo<v8::Value>& info)
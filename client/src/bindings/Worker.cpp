@@ -95,7 +95,8 @@ static void Emit(const v8::FunctionCallbackInfo<v8::Value>& info)
         }
         args.push_back(arg);
     }
-    worker->GetWorkerEventHandler().Emit(eventName.ToString(), args);
+    // Returns false if the worker is not keeping up and the event was dropped
+    V8_RETURN_BOOLEAN(worker->GetWorkerEventHandler().Emit(eventName.ToString(), std::move(args)));
 }
 
 static void On(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -22,10 +22,11 @@ V8_LOCAL_EVENT_HANDLER removeEntity(EventType::REMOVE_ENTITY_EVENT, "removeEntit
 
 V8_EVENT_HANDLER gameEntityCreate(
   EventType::GAME_ENTITY_CREATE,
-  [](V8ResourceImpl* resource, const alt::CEvent* e) {
+  [](V8ResourceImpl* resource, const alt::CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       CV8ScriptRuntime::Instance().OnEntityStreamIn(static_cast<const alt::CGameEntityCreateEvent*>(e)->GetTarget());
 
-      return resource->GetLocalHandlers("gameEntityCreate");
+      static V8Helpers::EventNames::Id eventId = V8Helpers::EventNames::Intern("gameEntityCreate");
+      return resource->GetLocalHandlers(eventId);
   },
   [](V8ResourceImpl* resource, const alt::CEvent* e, std::vector<v8::Local<v8::Value>>& args) {
       auto ev = static_cast<const alt::CGameEntityCreateEvent*>(e);
@@ -36,10 +37,11 @@ V8_EVENT_HANDLER gameEntityCreate(
 
 V8_EVENT_HANDLER gameEntityDestroy(
   EventType::GAME_ENTITY_DESTROY,
-  [](V8ResourceImpl* resource, const alt::CEvent* e) {
+  [](V8ResourceImpl* resource, const alt::CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       CV8ScriptRuntime::Instance().OnEntityStreamOut(static_cast<const alt::CGameEntityDestroyEvent*>(e)->GetTarget());
 
-      return resource->GetLocalHandlers("gameEntityDestroy");
+      static V8Helpers::EventNames::Id eventId = V8Helpers::EventNames::Intern("gameEntityDestroy");
+      return resource->GetLocalHandlers(eventId);
   },
   [](V8ResourceImpl* resource, const alt::CEvent* e, std::vector<v8::Local<v8::Value>>& args) {
       auto ev = static_cast<const alt::CGameEntityDestroyEvent*>(e);
@@ -24,7 +24,7 @@ using EventType = CEvent::Type;
 
 V8_EVENT_HANDLER clientScriptEvent(
   EventType::CLIENT_SCRIPT_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CClientScriptEvent*>(e);
       return resource->GetLocalHandlers(ev->GetName().ToString());
   },
@@ -36,7 +36,7 @@ V8_EVENT_HANDLER clientScriptEvent(
 
 V8_EVENT_HANDLER serverScriptEvent(
   EventType::SERVER_SCRIPT_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CServerScriptEvent*>(e);
       return resource->GetRemoteHandlers(ev->GetName().ToString());
   },
@@ -48,7 +48,7 @@ V8_EVENT_HANDLER serverScriptEvent(
 
 V8_EVENT_HANDLER webviewEvent(
   EventType::WEB_VIEW_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CWebViewEvent*>(e);
 
       return static_cast<CV8ResourceImpl*>(resource)->GetWebViewHandlers(ev->GetTarget(), ev->GetName().ToString());
@@ -61,7 +61,7 @@ V8_EVENT_HANDLER webviewEvent(
 
 V8_EVENT_HANDLER webSocketEvent(
   EventType::WEB_SOCKET_CLIENT_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CWebSocketClientEvent*>(e);
 
       return static_cast<CV8ResourceImpl*>(resource)->GetWebSocketClientHandlers(ev->GetTarget(), ev->GetName().ToString());
@@ -74,7 +74,7 @@ V8_EVENT_HANDLER webSocketEvent(
 
 V8_EVENT_HANDLER audioEvent(
   EventType::AUDIO_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CAudioEvent*>(e);
 
       return static_cast<CV8ResourceImpl*>(resource)->GetAudioHandlers(ev->GetTarget(), ev->GetName().ToString());
@@ -87,7 +87,7 @@ V8_EVENT_HANDLER audioEvent(
 
 V8_EVENT_HANDLER rmlEvent(
   EventType::RMLUI_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CRmlEvent*>(e);
       return static_cast<CV8ResourceImpl*>(resource)->GetRmlHandlers(ev->GetElement(), ev->GetName());
   },
@@ -98,15 +98,17 @@ V8_EVENT_HANDLER rmlEvent(
 
 V8_EVENT_HANDLER keyboardEvent(
   EventType::KEYBOARD_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
+      static V8Helpers::EventNames::Id keyUpId = V8Helpers::EventNames::Intern("keyup");
+      static V8Helpers::EventNames::Id keyDownId = V8Helpers::EventNames::Intern("keydown");
       auto ev = static_cast<const alt::CKeyboardEvent*>(e);
-      if(ev->GetKeyState() == alt::CKeyboardEvent::KeyState::UP) return resource->GetLocalHandlers("keyup");
+      if(ev->GetKeyState() == alt::CKeyboardEvent::KeyState::UP) return resource->GetLocalHandlers(keyUpId);
       else if(ev->GetKeyState() == alt::CKeyboardEvent::KeyState::DOWN)
-          return resource->GetLocalHandlers("keydown");
+          return resource->GetLocalHandlers(keyDownId);
       else
       {
           Log::Error << "Unhandled keystate in keyboard event handler: " << (int)ev->GetKeyState() << Log::Endl;
-          return std::vector<V8Helpers::EventCallback*>();
+          return V8Helpers::EventCallbackMap::Empty();
       }
   },
   [](V8ResourceImpl* resource, const CEvent* e, std::vector<v8::Local<v8::Value>>& args) {
@@ -1,9 +1,11 @@
 #include "CEventHandler.h"
+#include "CTracer.h"
 
-void CEventHandler::Emit(const std::string& eventName, const std::vector<V8Helpers::Serialization::Value>& args)
+bool CEventHandler::Emit(const std::string& eventName, std::vector<V8Helpers::Serialization::Value>&& args)
 {
-    std::scoped_lock lock(queueLock);
-    queue.push(std::make_pair(eventName, std::move(args)));
+    if(!queue.Push(std::make_pair(eventName, std::move(args)))) return false;
+    if(notify) notify();
+    return true;
 }
 
 void CEventHandler::Subscribe(const std::string& eventName, v8::Local<v8::Function> callback, bool once)
@@ -35,50 +37,50 @@ void CEventHandler::CleanupHandlers()
 
 void CEventHandler::Process()
 {
-    if(queue.empty()) return;
+    // Only process the events that are queued right now, so a fast producer can't keep us here forever
+    size_t count = queue.GetSize();
+    if(count == 0) return;
     CleanupHandlers();
 
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
     auto context = isolate->GetEnteredOrMicrotaskContext();
 
-    while(!queue.empty())
+    for(size_t i = 0; i < count; i++)
     {
-        // Get the event at the front of the queue
-        queueLock.lock();
-        QueueItem& event = queue.front();
-
-        // Create a vector of the event arguments
-        std::vector<v8::Local<v8::Value>> args;
-        args.reserve(event.second.size());
-        for(auto& arg : event.second)
+        QueueItem* event = queue.Front();
+        // The trace scope uses the event name, so it has to end before the event is popped
         {
-            auto value = V8Helpers::Serialization::Deserialize(context, arg);
-            if(value.IsEmpty())
+            CTracer::Scope traceScope("worker", event->first);
+
+            // Create a vector of the event arguments
+            std::vector<v8::Local<v8::Value>> args;
+            args.reserve(event->second.size());
+            for(auto& arg : event->second)
             {
-                Log::Error << "Failed to deserialize worker event argument for event '" << event.first << "'" << Log::Endl;
-                continue;
+                auto value = V8Helpers::Serialization::Deserialize(context, arg);
+                if(value.IsEmpty())
+                {
+                    Log::Error << "Failed to deserialize worker event argument for event '" << event->first << "'" << Log::Endl;
+                    continue;
+                }
+                args.push_back(value.ToLocalChecked());
             }
-            args.push_back(value.ToLocalChecked());
-        }
-        auto evHandlers = handlers.equal_range(event.first);
-        queueLock.unlock();
+            auto evHandlers = handlers.equal_range(event->first);
 
-        // Call all handlers with the arguments
-        for(auto it = evHandlers.first; it != evHandlers.second; it++)
-        {
-            V8Helpers::CallFunctionWithTimeout(it->second.fn.Get(isolate), context, args);
-            if(it->second.once) it->second.removed = true;
+            // Call all handlers with the arguments
+            for(auto it = evHandlers.first; it != evHandlers.second; it++)
+            {
+                V8Helpers::CallFunctionWithTimeout(it->second.fn.Get(isolate), context, args);
+                if(it->second.once) it->second.removed = true;
+            }
         }
 
-        // Pop the event from the queue
-        queueLock.lock();
-        queue.pop();
-        queueLock.unlock();
+        queue.Pop();
     }
 }
 
 void CEventHandler::Reset()
 {
-    while(!queue.empty()) queue.pop();
+    while(queue.Front()) queue.Pop();
     handlers.clear();
 }
@@ -1,27 +1,37 @@
 #pragma once
 
-#include <queue>
 #include <string>
-#include <mutex>
+#include <functional>
 
 #include "V8Helpers.h"
+#include "CRingBuffer.h"
 
 class CEventHandler
 {
 public:
     using QueueItem = std::pair<std::string, std::vector<V8Helpers::Serialization::Value>>;
-    using Queue = std::queue<QueueItem>;
+    using Queue = CRingBuffer<QueueItem>;
     using HandlerMap = std::unordered_multimap<std::string, V8Helpers::EventCallback>;
 
+    // Maximum amount of events waiting to be processed, emitting more fails until the queue is drained
+    static constexpr size_t QueueCapacity = 4096;
+
 private:
-    Queue queue;
-    std::mutex queueLock;
+    Queue queue{ QueueCapacity };
     HandlerMap handlers;
+    // Called after an event was queued, used to wake up the consuming thread
+    std::function<void()> notify;
 
     void CleanupHandlers();
 
 public:
-    void Emit(const std::string& eventName, const std::vector<V8Helpers::Serialization::Value>& args);
+    void SetNotify(std::function<void()>&& callback)
+    {
+        notify = std::move(callback);
+    }
+
+    // Has to be called from the same thread for every emit, returns false if the queue is full
+    bool Emit(const std::string& eventName, std::vector<V8Helpers::Serialization::Value>&& args);
     void Subscribe(const std::string& eventName, v8::Local<v8::Function> callback, bool once = false);
     void Unsubscribe(const std::string& eventName, v8::Local<v8::Function> callback);
 
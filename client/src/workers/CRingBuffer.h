@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer and one consumer thread
+template<class T>
+class CRingBuffer
+{
+    std::vector<T> items;
+    size_t capacity;
+
+    // Only written by the consumer
+    alignas(64) std::atomic<size_t> head = 0;
+    // Only written by the producer
+    alignas(64) std::atomic<size_t> tail = 0;
+
+public:
+    CRingBuffer(size_t _capacity) : items(_capacity), capacity(_capacity) {}
+
+    CRingBuffer(const CRingBuffer&) = delete;
+    CRingBuffer& operator=(const CRingBuffer&) = delete;
+
+    // Producer only, returns false if the queue is full
+    bool Push(T&& item)
+    {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if(currentTail - head.load(std::memory_order_acquire) == capacity) return false;
+
+        items[currentTail % capacity] = std::move(item);
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, returns nullptr if the queue is empty.
+    // The item stays valid until it is popped
+    T* Front()
+    {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if(currentHead == tail.load(std::memory_order_acquire)) return nullptr;
+        return &items[currentHead % capacity];
+    }
+
+    // Consumer only
+    void Pop()
+    {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        // Release the resources of the item now instead of when the slot gets reused
+        items[currentHead % capacity] = T{};
+        head.store(currentHead + 1, std::memory_order_release);
+    }
+
+    size_t GetSize() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    size_t GetCapacity() const
+    {
+        return capacity;
+    }
+};
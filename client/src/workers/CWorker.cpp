@@ -6,10 +6,16 @@
 #include "V8Module.h"
 #include "WorkerTimer.h"
 #include "V8FastFunction.h"
+#include "CTracer.h"
+#include "CWatchdog.h"
 
 #include <functional>
+#include <algorithm>
 
-CWorker::CWorker(std::string& filePath, std::string& origin, CV8ResourceImpl* resource) : filePath(filePath), origin(origin), resource(resource) {}
+CWorker::CWorker(std::string& filePath, std::string& origin, CV8ResourceImpl* resource) : filePath(filePath), origin(origin), resource(resource)
+{
+    workerEvents.SetNotify([this]() { Wake(); });
+}
 
 void CWorker::Start()
 {
@@ -20,12 +26,46 @@ void CWorker::Start()
 
 void CWorker::Destroy()
 {
-    shouldTerminate = true;
     if(isolate && !isPaused) CV8ScriptRuntime::Instance().RemoveActiveWorker();
+
+    // Notify while holding the lock, the worker deletes itself as soon as it sees the flag
+    std::scoped_lock lock(wakeLock);
+    shouldTerminate = true;
+    wakeRequested = true;
+    wakeCondition.notify_one();
+}
+
+void CWorker::Wake()
+{
+    {
+        std::scoped_lock lock(wakeLock);
+        wakeRequested = true;
+    }
+    wakeCondition.notify_one();
+}
+
+void CWorker::WaitForWork()
+{
+    // Tasks posted by the platform don't wake us up, so never sleep longer than this
+    int64_t timeout = 5;
+    if(!isPaused)
+    {
+        int64_t now = GetTime();
+        for(auto& p : timers) timeout = std::min(timeout, p.second->GetNextRun() - now);
+    }
+
+    // If a timer is already due, still give the thread a short break to not overload it
+    auto duration = timeout > 0 ? std::chrono::microseconds(timeout * 1000) : std::chrono::microseconds(500);
+
+    std::unique_lock lock(wakeLock);
+    wakeCondition.wait_for(lock, duration, [this]() { return wakeRequested; });
+    wakeRequested = false;
 }
 
 void CWorker::Thread()
 {
+    if(CTracer::Instance().IsEnabled()) CTracer::Instance().SetThreadName("Worker " + filePath);
+
     bool result = Setup();
     if(!result) shouldTerminate = true;
     else
@@ -33,7 +73,7 @@ void CWorker::Thread()
         // Isolate is set up, the worker is now ready
         isReady = true;
         std::vector<V8Helpers::Serialization::Value> args;
-        GetMainEventHandler().Emit("load", args);
+        GetMainEventHandler().Emit("load", std::move(args));
 
         v8::Locker locker(isolate);
         v8::Isolate::Scope isolate_scope(isolate);
@@ -41,12 +81,16 @@ void CWorker::Thread()
         v8::Context::Scope context_scope(context.Get(isolate));
         while(true)
         {
-            // Sleep for a short while to not overload the thread
-            std::this_thread::sleep_for(std::chrono::microseconds(500));
             if(!EventLoop()) break;
+            // Sleep until an event is emitted to the worker or the next timer is due
+            WaitForWork();
         }
     }
     DestroyIsolate();
+    // Wait for a concurrent Destroy or Wake call to release the lock
+    {
+        std::scoped_lock lock(wakeLock);
+    }
     delete this;  // ! IMPORTANT TO DO THIS LAST !
 }
 
@@ -253,7 +297,12 @@ bool CWorker::SetupScript()
         }
 
         // Evaluate the code
-        auto returnValue = mod->Evaluate(ctx);
+        v8::MaybeLocal<v8::Value> returnValue;
+        {
+            CWatchdog::Scope watchdogScope(isolate, resource->GetExecutionTimeout());
+            returnValue = mod->Evaluate(ctx);
+            if(watchdogScope.Leave()) returnValue = v8::MaybeLocal<v8::Value>();
+        }
         if(returnValue.IsEmpty())
         {
             EmitError("Failed to evaluate worker module");
@@ -326,7 +375,7 @@ void CWorker::EmitError(const std::string& error)
 {
     Log::Error << "[Worker] " << error << Log::Endl;
     std::vector<V8Helpers::Serialization::Value> args = { V8Helpers::Serialization::Serialize(context.Get(isolate), V8Helpers::JSValue(error)) };
-    GetMainEventHandler().Emit("error", args);
+    GetMainEventHandler().Emit("error", std::move(args));
 }
 
 CWorker::TimerId CWorker::CreateTimer(v8::Local<v8::Function> callback, uint32_t interval, bool once, V8Helpers::SourceLocation&& location)
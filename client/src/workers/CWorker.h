@@ -10,6 +10,9 @@
 #include <map>
 #include <queue>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 class CV8ResourceImpl;
 class WorkerTimer;
@@ -28,9 +31,14 @@ private:
     std::string origin;
     std::thread thread;
     CV8ResourceImpl* resource;
-    bool shouldTerminate = false;
+    std::atomic<bool> shouldTerminate = false;
     bool isReady = false;
-    bool isPaused = false;
+    std::atomic<bool> isPaused = false;
+
+    // Used to put the worker thread to sleep while it has nothing to do
+    std::mutex wakeLock;
+    std::condition_variable wakeCondition;
+    bool wakeRequested = false;
 
     CEventHandler mainEvents;
     CEventHandler workerEvents;
@@ -51,6 +59,7 @@ private:
     void Thread();
 
     bool EventLoop();
+    void WaitForWork();
 
     bool Setup();
     void SetupIsolate();
@@ -81,7 +90,10 @@ public:
     void Resume()
     {
         isPaused = false;
+        Wake();
     }
+    // Wakes up the worker thread if it is waiting for work, can be called from any thread
+    void Wake();
 
     TimerId CreateTimer(v8::Local<v8::Function> callback, uint32_t interval, bool once, V8Helpers::SourceLocation&& location);
     void RemoveTimer(TimerId id)
@@ -23,7 +23,8 @@ void Emit(const v8::FunctionCallbackInfo<v8::Value>& info)
         }
         args.push_back(arg);
     }
-    worker->GetMainEventHandler().Emit(eventName.ToString(), args);
+    // Returns false if the main thread is not keeping up and the event was dropped
+    V8_RETURN_BOOLEAN(worker->GetMainEventHandler().Emit(eventName.ToString(), std::move(args)));
 }
 
 void On(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -40,6 +40,10 @@ public:
     {
         return location;
     }
+    int64_t GetNextRun()
+    {
+        return lastRun + interval;
+    }
     int64_t GetInterval()
     {
         return interval;
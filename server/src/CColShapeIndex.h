@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#include "cpp-sdk/objects/IColShape.h"
+
+// Uniform grid over the XY plane that indexes the bounds of the colshapes created by scripts,
+// so looking up the colshapes at a position only has to check the colshapes of the cells around it
+class CColShapeIndex
+{
+public:
+    static constexpr float CellSize = 64.f;
+    // Colshapes covering more cells are kept in a separate list that is checked by every query
+    static constexpr int64_t MaxCells = 1024;
+    // Coordinates outside of the cell range end up in the outermost cells, leaves room to iterate past them
+    static constexpr int32_t MaxCell = 1 << 30;
+
+    static constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+    struct Bounds
+    {
+        float minX, minY, minZ;
+        float maxX, maxY, maxZ;
+    };
+
+private:
+    struct Entry
+    {
+        alt::Ref<alt::IColShape> shape;
+        // Relative to the position of the colshape, so moving it doesn't need the shape parameters
+        Bounds bounds;
+        int32_t cellMinX, cellMinY, cellMaxX, cellMaxY;
+        bool large;
+        uint32_t queryId = 0;
+    };
+
+    std::unordered_map<alt::IColShape*, Entry> entries;
+    std::unordered_map<uint64_t, std::vector<alt::IColShape*>> cells;
+    std::vector<alt::IColShape*> largeShapes;
+    uint32_t lastQueryId = 0;
+
+    static int32_t GetCell(float value)
+    {
+        float cell = std::floor(value / CellSize);
+        // Casting values outside of the int32 range is undefined, also catches NaN
+        if(!(cell >= -MaxCell)) return -MaxCell;
+        if(cell > MaxCell) return MaxCell;
+        return (int32_t)cell;
+    }
+    static uint64_t GetCellKey(int32_t x, int32_t y)
+    {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+    }
+
+    static Bounds GetAbsoluteBounds(const Entry& entry)
+    {
+        alt::Position pos = entry.shape->GetPosition();
+        const Bounds& bounds = entry.bounds;
+        return { bounds.minX + pos[0], bounds.minY + pos[1], bounds.minZ + pos[2], bounds.maxX + pos[0], bounds.maxY + pos[1], bounds.maxZ + pos[2] };
+    }
+
+    void Insert(alt::IColShape* shape, Entry& entry)
+    {
+        Bounds bounds = GetAbsoluteBounds(entry);
+        entry.cellMinX = GetCell(bounds.minX);
+        entry.cellMinY = GetCell(bounds.minY);
+        entry.cellMaxX = GetCell(bounds.maxX);
+        entry.cellMaxY = GetCell(bounds.maxY);
+        entry.large = ((int64_t)entry.cellMaxX - entry.cellMinX + 1) * ((int64_t)entry.cellMaxY - entry.cellMinY + 1) > MaxCells;
+
+        if(entry.large)
+        {
+            largeShapes.push_back(shape);
+            return;
+        }
+        for(int32_t x = entry.cellMinX; x <= entry.cellMaxX; x++)
+        {
+            for(int32_t y = entry.cellMinY; y <= entry.cellMaxY; y++) cells[GetCellKey(x, y)].push_back(shape);
+        }
+    }
+
+    static void Erase(std::vector<alt::IColShape*>& shapes, alt::IColShape* shape)
+    {
+        for(size_t i = 0; i < shapes.size(); i++)
+        {
+            if(shapes[i] != shape) continue;
+            shapes[i] = shapes.back();
+            shapes.pop_back();
+            return;
+        }
+    }
+
+    void Unlink(alt::IColShape* shape, Entry& entry)
+    {
+        if(entry.large)
+        {
+            Erase(largeShapes, shape);
+            return;
+        }
+        for(int32_t x = entry.cellMinX; x <= entry.cellMaxX; x++)
+        {
+            for(int32_t y = entry.cellMinY; y <= entry.cellMaxY; y++)
+            {
+                auto it = cells.find(GetCellKey(x, y));
+                if(it == cells.end()) continue;
+                Erase(it->second, shape);
+                if(it->second.empty()) cells.erase(it);
+            }
+        }
+    }
+
+    // Calls the callback once for every colshape whose cells overlap the area
+    template<class Callback>
+    void ForEachCandidate(float minX, float minY, float maxX, float maxY, Callback&& callback)
+    {
+        uint32_t queryId = ++lastQueryId;
+        auto visit = [&](alt::IColShape* shape) {
+            Entry& entry = entries.at(shape);
+            if(entry.queryId == queryId) return;
+            entry.queryId = queryId;
+            callback(entry);
+        };
+
+        for(alt::IColShape* shape : largeShapes) visit(shape);
+
+        int32_t cellMinX = GetCell(minX), cellMinY = GetCell(minY), cellMaxX = GetCell(maxX), cellMaxY = GetCell(maxY);
+        // Areas spanning more cells than are in use are cheaper to check by going over the used cells
+        if(((int64_t)cellMaxX - cellMinX + 1) * ((int64_t)cellMaxY - cellMinY + 1) > (int64_t)cells.size())
+        {
+            for(auto& [key, shapes] : cells)
+            {
+                int32_t x = (int32_t)(key >> 32), y = (int32_t)(uint32_t)key;
+                if(x < cellMinX || x > cellMaxX || y < cellMinY || y > cellMaxY) continue;
+                for(alt::IColShape* shape : shapes) visit(shape);
+            }
+            return;
+        }
+
+        for(int32_t x = cellMinX; x <= cellMaxX; x++)
+        {
+            for(int32_t y = cellMinY; y <= cellMaxY; y++)
+            {
+                auto it = cells.find(GetCellKey(x, y));
+                if(it == cells.end()) continue;
+                for(alt::IColShape* shape : it->second) visit(shape);
+            }
+        }
+    }
+
+public:
+    // Bounds are absolute at the current position of the colshape, use infinite Z bounds for 2D colshapes
+    void Add(alt::Ref<alt::IColShape> shape, const Bounds& bounds)
+    {
+        if(!shape) return;
+        Remove(shape.Get());
+
+        alt::Position pos = shape->GetPosition();
+        Entry entry;
+        entry.shape = shape;
+        entry.bounds = { bounds.minX - pos[0], bounds.minY - pos[1], bounds.minZ - pos[2], bounds.maxX - pos[0], bounds.maxY - pos[1], bounds.maxZ - pos[2] };
+        Insert(shape.Get(), entries.emplace(shape.Get(), entry).first->second);
+    }
+
+    // Has to be called after the position of the colshape changed
+    void Update(alt::IColShape* shape)
+    {
+        auto it = entries.find(shape);
+        if(it == entries.end()) return;
+        Unlink(shape, it->second);
+        Insert(shape, it->second);
+    }
+
+    void Remove(alt::IColShape* shape)
+    {
+        auto it = entries.find(shape);
+        if(it == entries.end()) return;
+        Unlink(shape, it->second);
+        entries.erase(it);
+    }
+
+    // Colshapes that contain the point
+    void QueryPoint(const alt::Vector3f& pos, std::vector<alt::IColShape*>& result)
+    {
+        ForEachCandidate(pos[0], pos[1], pos[0], pos[1], [&](Entry& entry) {
+            Bounds bounds = GetAbsoluteBounds(entry);
+            if(pos[0] < bounds.minX || pos[0] > bounds.maxX || pos[1] < bounds.minY || pos[1] > bounds.maxY || pos[2] < bounds.minZ || pos[2] > bounds.maxZ) return;
+            if(entry.shape->IsPointIn(pos)) result.push_back(entry.shape.Get());
+        });
+    }
+
+    // Colshapes whose bounds intersect the sphere. The colshapes themselves are not checked,
+    // so corners of spheres, cylinders and polygons can match although the colshape is out of range
+    void QueryBoundsInRadius(const alt::Vector3f& pos, float radius, std::vector<alt::IColShape*>& result)
+    {
+        ForEachCandidate(pos[0] - radius, pos[1] - radius, pos[0] + radius, pos[1] + radius, [&](Entry& entry) {
+            Bounds bounds = GetAbsoluteBounds(entry);
+            float dx = std::max(std::max(bounds.minX - pos[0], 0.f), pos[0] - bounds.maxX);
+            float dy = std::max(std::max(bounds.minY - pos[1], 0.f), pos[1] - bounds.maxY);
+            float dz = std::max(std::max(bounds.minZ - pos[2], 0.f), pos[2] - bounds.maxZ);
+            if(dx * dx + dy * dy + dz * dz <= radius * radius) result.push_back(entry.shape.Get());
+        });
+    }
+
+    void Clear()
+    {
+        entries.clear();
+        cells.clear();
+        largeShapes.clear();
+    }
+
+    size_t GetSize() const
+    {
+        return entries.size();
+    }
+
+    static CColShapeIndex& Instance()
+    {
+        static CColShapeIndex instance;
+        return instance;
+    }
+};
@@ -4,6 +4,9 @@
 #include "CNodeScriptRuntime.h"
 #include "V8Module.h"
 #include "V8Helpers.h"
+#include "CColShapeIndex.h"
+
+#include "cpp-sdk/events/CResourceStopEvent.h"
 
 #include "JSBindings.h"
 
@@ -28,6 +31,8 @@ static const char bootstrap_code[] =
 
 bool CNodeResourceImpl::Start()
 {
+    CTracer::Scope traceScope("resource", "Start", resource->GetName().CStr());
+
     v8::Locker locker(isolate);
     v8::Isolate::Scope isolateScope(isolate);
     v8::HandleScope handleScope(isolate);
@@ -40,11 +45,36 @@ bool CNodeResourceImpl::Start()
     v8::Context::Scope scope(_context);
 
     _context->Global()->Set(_context, V8Helpers::JSValue("__resourceLoaded"), v8::Function::New(_context, &ResourceLoaded).ToLocalChecked());
-    _context->Global()->Set(_context, V8Helpers::JSValue("__internal_bindings_code"), V8Helpers::JSValue(JSBindings::GetBindingsCode()));
 
     _context->SetAlignedPointerInEmbedderData(1, resource);
     context.Reset(isolate, _context);
 
+    // The bootstrap can't run without the bindings, it would only fail with an unrelated error
+    bool bindingsCompiled = V8Helpers::TryCatch([&] {
+        v8::Local<v8::Function> bindings;
+        if(!JSBindings::Compile(_context, { V8Helpers::JSValue("alt") }).ToLocal(&bindings)) return false;
+        _context->Global()->Set(_context, V8Helpers::JSValue("__internal_bindings"), bindings);
+        return true;
+    });
+    if(!bindingsCompiled)
+    {
+        Log::Error << "[V8] Failed to compile the JS bindings for resource " << resource->GetName() << Log::Endl;
+        startError = true;
+    }
+
+    alt::config::Node timeout = resource->GetConfig()["execution-timeout"];
+    if(!timeout.IsNone())
+    {
+        try
+        {
+            executionTimeout = (uint32_t)timeout.ToNumber();
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'execution-timeout' config option of resource " << resource->GetName() << Log::Endl;
+        }
+    }
+
     V8ResourceImpl::Start();
 
     node::EnvironmentFlags::Flags flags = (node::EnvironmentFlags::Flags)(node::EnvironmentFlags::kOwnsProcessState & node::EnvironmentFlags::kNoCreateInspector);
@@ -58,7 +88,18 @@ bool CNodeResourceImpl::Start()
     node::IsolateSettings is;
     node::SetIsolateUpForNode(isolate, is);
 
-    node::LoadEnvironment(env, bootstrap_code);
+    int64_t startTime = GetMicroTime();
+    if(!startError)
+    {
+        // Only covers the synchronous part of the bootstrap, the module itself is evaluated asynchronously
+        CWatchdog::Scope watchdogScope(isolate, executionTimeout);
+        node::LoadEnvironment(env, bootstrap_code);
+        if(watchdogScope.Leave())
+        {
+            Log::Error << "[V8] Loading resource " << resource->GetName() << " exceeded " << executionTimeout << "ms and was terminated" << Log::Endl;
+            startError = true;
+        }
+    }
 
     asyncResource.Reset(isolate, v8::Object::New(isolate));
     asyncContext = node::EmitAsyncInit(isolate, asyncResource.Get(isolate), "CNodeResourceImpl");
@@ -68,6 +109,8 @@ bool CNodeResourceImpl::Start()
         runtime->OnTick();
         OnTick();
     }
+    stats.startTime = GetMicroTime() - startTime;
+    CTracer::Instance().Record("resource", "Evaluate", resource->GetName().CStr(), startTime, startTime + stats.startTime);
 
     DispatchStartEvent(startError);
 
@@ -76,6 +119,8 @@ bool CNodeResourceImpl::Start()
 
 bool CNodeResourceImpl::Stop()
 {
+    CTracer::Scope traceScope("resource", "Stop", resource->GetName().CStr());
+
     v8::Locker locker(isolate);
     v8::Isolate::Scope isolateScope(isolate);
     v8::HandleScope handleScope(isolate);
@@ -117,6 +162,15 @@ void CNodeResourceImpl::Started(v8::Local<v8::Value> _exports)
     }
 }
 
+void CNodeResourceImpl::OnRemoveBaseObject(alt::Ref<alt::IBaseObject> handle)
+{
+    // Every resource is notified, removing from the shared index again is a no-op
+    alt::IBaseObject::Type type = handle->GetType();
+    if(type == alt::IBaseObject::Type::COLSHAPE || type == alt::IBaseObject::Type::CHECKPOINT) CColShapeIndex::Instance().Remove(handle.As<alt::IColShape>().Get());
+
+    V8ResourceImpl::OnRemoveBaseObject(handle);
+}
+
 bool CNodeResourceImpl::OnEvent(const alt::CEvent* e)
 {
     v8::Locker locker(isolate);
@@ -129,37 +183,40 @@ bool CNodeResourceImpl::OnEvent(const alt::CEvent* e)
     V8Helpers::EventHandler* handler = V8Helpers::EventHandler::Get(e);
     if(!handler) return true;
 
+    std::string traceName = CTracer::Instance().IsEnabled() ? GetEventTraceName(e) : std::string();
+    CTracer::Scope traceScope("event", traceName, resource->GetName().CStr());
+
     // Generic event handler
     {
         auto evType = e->GetType();
         if(evType == alt::CEvent::Type::CLIENT_SCRIPT_EVENT || evType == alt::CEvent::Type::SERVER_SCRIPT_EVENT)
         {
-            std::vector<V8Helpers::EventCallback*> callbacks;
+            const std::vector<V8Helpers::EventCallback*>* callbacks = nullptr;
             const char* eventName;
 
             if(evType == alt::CEvent::Type::SERVER_SCRIPT_EVENT)
             {
-                callbacks = std::move(GetGenericHandlers(true));
+                callbacks = &GetGenericHandlers(true);
                 eventName = static_cast<const alt::CServerScriptEvent*>(e)->GetName().CStr();
             }
             else if(evType == alt::CEvent::Type::CLIENT_SCRIPT_EVENT)
             {
-                callbacks = std::move(GetGenericHandlers(false));
+                callbacks = &GetGenericHandlers(false);
                 eventName = static_cast<const alt::CClientScriptEvent*>(e)->GetName().CStr();
             }
 
-            if(callbacks.size() != 0)
+            if(callbacks && callbacks->size() != 0)
             {
                 auto evArgs = handler->GetArgs(this, e);
                 evArgs.insert(evArgs.begin(), V8Helpers::JSValue(eventName));
 
                 node::CallbackScope callbackScope(isolate, asyncResource.Get(isolate), asyncContext);
-                InvokeEventHandlers(e, callbacks, evArgs);
+                InvokeEventHandlers(e, *callbacks, evArgs);
             }
         }
     }
 
-    std::vector<V8Helpers::EventCallback*> callbacks = handler->GetCallbacks(this, e);
+    const std::vector<V8Helpers::EventCallback*>& callbacks = handler->GetCallbacks(this, e);
     if(callbacks.size() > 0)
     {
         std::vector<v8::Local<v8::Value>> args = handler->GetArgs(this, e);
@@ -168,6 +225,8 @@ bool CNodeResourceImpl::OnEvent(const alt::CEvent* e)
         InvokeEventHandlers(e, callbacks, args);
     }
 
+    if(e->GetType() == alt::CEvent::Type::RESOURCE_STOP) OnResourceStopped(static_cast<const alt::CResourceStopEvent*>(e)->GetResource());
+
     // env->PopAsyncCallbackScope();
     return true;
 }
@@ -179,10 +238,32 @@ void CNodeResourceImpl::OnTick()
     v8::HandleScope handleScope(isolate);
 
     v8::Context::Scope scope(GetContext());
-    node::CallbackScope callbackScope(isolate, asyncResource.Get(isolate), asyncContext);
 
-    uv_run(uvLoop, UV_RUN_NOWAIT);
-    V8ResourceImpl::OnTick();
+    int64_t tickEnd;
+    {
+        node::CallbackScope callbackScope(isolate, asyncResource.Get(isolate), asyncContext);
+
+        int64_t uvStart = GetMicroTime();
+        uv_run(uvLoop, UV_RUN_NOWAIT);
+        loopStats.uvRunTime.Record(GetMicroTime() - uvStart);
+
+        V8ResourceImpl::OnTick();
+        tickEnd = GetMicroTime();
+    }
+    // Microtasks and the nextTick queue are drained when the callback scope is closed
+    loopStats.microtaskTime.Record(GetMicroTime() - tickEnd);
+
+    loopStats.activeHandles = uvLoop->active_handles;
+    loopStats.activeRequests = uvLoop->active_reqs.count;
+}
+
+void CNodeResourceImpl::LogStats()
+{
+    V8ResourceImpl::LogStats();
+
+    LogHistogram("uv_run", loopStats.uvRunTime);
+    LogHistogram("Microtasks", loopStats.microtaskTime);
+    Log::Info << "  Event loop: " << loopStats.activeHandles << " active handles, " << loopStats.activeRequests << " active requests" << Log::Endl;
 }
 
 bool CNodeResourceImpl::MakeClient(alt::IResource::CreationInfo* info, alt::Array<alt::String>)
@@ -16,6 +16,18 @@ class CNodeScriptRuntime;
 class CNodeResourceImpl : public V8ResourceImpl
 {
 public:
+    // Health of the event loop of the resource, times are in microseconds
+    struct LoopStats
+    {
+        // Time spent running the libuv loop every tick
+        CHistogram uvRunTime;
+        // Time spent draining the microtask and nextTick queues after every tick
+        CHistogram microtaskTime;
+        // Amount of handles and requests that keep the loop alive, as of the last tick
+        uint32_t activeHandles = 0;
+        uint32_t activeRequests = 0;
+    };
+
     CNodeResourceImpl(CNodeScriptRuntime* _runtime, v8::Isolate* isolate, alt::IResource* resource) : V8ResourceImpl(isolate, resource), runtime(_runtime) {}
 
     CNodeResourceImpl(const CNodeResourceImpl&) = delete;
@@ -26,6 +38,8 @@ public:
     bool OnEvent(const alt::CEvent* ev) override;
     void OnTick() override;
 
+    void OnRemoveBaseObject(alt::Ref<alt::IBaseObject> handle) override;
+
     bool MakeClient(alt::IResource::CreationInfo* info, alt::Array<alt::String>) override;
 
     void Started(v8::Local<v8::Value> exports);
@@ -46,6 +60,12 @@ public:
         return envStarted;
     }
 
+    LoopStats& GetLoopStats()
+    {
+        return loopStats;
+    }
+    void LogStats() override;
+
 private:
     CNodeScriptRuntime* runtime;
 
@@ -57,4 +77,6 @@ private:
     uv_loop_t* uvLoop = nullptr;
     v8::Persistent<v8::Object> asyncResource;
     node::async_context asyncContext{};
+
+    LoopStats loopStats;
 };
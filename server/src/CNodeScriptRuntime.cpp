@@ -2,6 +2,8 @@
 
 #include "CNodeScriptRuntime.h"
 #include "CProfiler.h"
+#include "CTracer.h"
+#include "CWatchdog.h"
 
 bool CNodeScriptRuntime::Init()
 {
@@ -61,6 +63,55 @@ void CNodeScriptRuntime::OnTick()
     v8::SealHandleScope seal(isolate);
 
     platform->DrainTasks(isolate);
+
+    MeasureHeap();
+}
+
+// Attributes the heap usage of the shared isolate to the contexts of the resources
+class HeapMeasureDelegate : public v8::MeasureMemoryDelegate
+{
+public:
+    bool ShouldMeasure(v8::Local<v8::Context> context) override
+    {
+        for(CNodeResourceImpl* resource : CNodeScriptRuntime::Instance().GetResources())
+        {
+            if(resource->IsEnvStarted() && resource->GetContext() == context) return true;
+        }
+        return false;
+    }
+
+    void MeasurementComplete(const std::vector<std::pair<v8::Local<v8::Context>, size_t>>& contextSizes, size_t) override
+    {
+        CNodeScriptRuntime& runtime = CNodeScriptRuntime::Instance();
+        runtime.OnHeapMeasured();
+
+        // Resources might have been stopped in the meantime, so only update the ones that still exist
+        for(CNodeResourceImpl* resource : runtime.GetResources())
+        {
+            if(!resource->IsEnvStarted()) continue;
+            v8::Local<v8::Context> resourceContext = resource->GetContext();
+            for(auto& [context, size] : contextSizes)
+            {
+                if(context != resourceContext) continue;
+                resource->GetStats().heapSize = (int64_t)size;
+                break;
+            }
+        }
+    }
+};
+
+void CNodeScriptRuntime::MeasureHeap()
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if(heapMeasurePending || now < nextHeapMeasure || resources.empty()) return;
+
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope handleScope(isolate);
+
+    // The measurement is folded into the next regular GC, so it usually doesn't cause any extra pauses
+    heapMeasurePending = isolate->MeasureMemory(std::make_unique<HeapMeasureDelegate>(), v8::MeasureMemoryExecution::kDefault);
+    nextHeapMeasure = now + heapMeasureInterval;
 }
 
 void CNodeScriptRuntime::OnDispose()
@@ -88,6 +139,7 @@ void CNodeScriptRuntime::OnDispose()
     // node::FreePlatform(platform.release());
 
     if(CProfiler::Instance().IsEnabled()) CProfiler::Instance().Dump("./");
+    if(CTracer::Instance().IsEnabled()) CTracer::Instance().Dump("./");
 }
 
 std::vector<std::string> CNodeScriptRuntime::GetNodeArgs()
@@ -204,4 +256,83 @@ void CNodeScriptRuntime::ProcessConfigOptions()
             Log::Error << "Invalid value for 'logs' profiler config option" << Log::Endl;
         }
     }
+
+    alt::config::Node tracer = moduleConfig["tracer"];
+    if(!tracer.IsNone())
+    {
+        try
+        {
+            bool result = tracer.ToBool();
+            CTracer::Instance().SetIsEnabled(result);
+            if(result) CTracer::Instance().SetThreadName("Main");
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'tracer' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node sourceLocations = moduleConfig["source-locations"];
+    if(!sourceLocations.IsNone())
+    {
+        try
+        {
+            V8Helpers::SourceLocation::CaptureMode mode;
+            if(V8Helpers::SourceLocation::ParseCaptureMode(sourceLocations.ToString(), mode))
+            {
+                uint32_t sampleRate = 0;
+                alt::config::Node sampleRateNode = moduleConfig["source-locations-sample-rate"];
+                if(!sampleRateNode.IsNone()) sampleRate = (uint32_t)sampleRateNode.ToNumber();
+                V8Helpers::SourceLocation::SetCaptureMode(mode, sampleRate);
+            }
+            else
+                Log::Error << "Invalid value for 'source-locations' config option, expected 'off', 'sampled', 'lazy' or 'always'" << Log::Endl;
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'source-locations' config option" << Log::Endl;
+        }
+    }
+
+    // Sitting on a breakpoint counts towards the execution time, so don't terminate scripts while debugging by default
+    alt::config::Node executionTimeout = moduleConfig["execution-timeout"];
+    if(!executionTimeout.IsNone())
+    {
+        try
+        {
+            CWatchdog::Instance().SetDefaultTimeout((uint32_t)executionTimeout.ToNumber());
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'execution-timeout' config option" << Log::Endl;
+        }
+    }
+    else if(!moduleConfig["inspector"].IsNone())
+        CWatchdog::Instance().SetDefaultTimeout(0);
+
+    alt::config::Node weakEntities = moduleConfig["weak-entities"];
+    if(!weakEntities.IsNone())
+    {
+        try
+        {
+            V8Entity::SetWrappersWeak(weakEntities.ToBool());
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'weak-entities' config option" << Log::Endl;
+        }
+    }
+
+    alt::config::Node asyncEventTimeout = moduleConfig["async-event-timeout"];
+    if(!asyncEventTimeout.IsNone())
+    {
+        try
+        {
+            V8ResourceImpl::SetAsyncEventTimeout((uint32_t)asyncEventTimeout.ToNumber());
+        }
+        catch(alt::config::Error&)
+        {
+            Log::Error << "Invalid value for 'async-event-timeout' config option" << Log::Endl;
+        }
+    }
 }
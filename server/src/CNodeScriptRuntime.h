@@ -5,6 +5,7 @@
 
 #include "V8Helpers.h"
 #include "CNodeResourceImpl.h"
+#include "CColShapeIndex.h"
 
 class CNodeScriptRuntime : public alt::IScriptRuntime
 {
@@ -12,6 +13,13 @@ class CNodeScriptRuntime : public alt::IScriptRuntime
     std::unique_ptr<node::MultiIsolatePlatform> platform;
     std::unordered_set<CNodeResourceImpl*> resources;
 
+    // Resource heap sizes are measured in the background every few seconds, so the stats stay up to date
+    static constexpr int64_t heapMeasureInterval = 10000;
+    int64_t nextHeapMeasure = 0;
+    bool heapMeasurePending = false;
+
+    void MeasureHeap();
+
 public:
     CNodeScriptRuntime() = default;
     bool Init();
@@ -25,8 +33,11 @@ public:
 
     void DestroyImpl(alt::IResource::Impl* impl) override
     {
-        resources.insert(static_cast<CNodeResourceImpl*>(impl));
+        resources.erase(static_cast<CNodeResourceImpl*>(impl));
         delete static_cast<CNodeResourceImpl*>(impl);
+
+        // Removals are only noticed by running resources, so don't keep colshapes nobody is notified about anymore
+        if(resources.empty()) CColShapeIndex::Instance().Clear();
     }
 
     void OnTick() override;
@@ -45,6 +56,11 @@ public:
         return resources;
     }
 
+    void OnHeapMeasured()
+    {
+        heapMeasurePending = false;
+    }
+
     static CNodeScriptRuntime& Instance()
     {
         static CNodeScriptRuntime _Instance;
@@ -2,6 +2,7 @@
 
 #include "V8Helpers.h"
 #include "V8ResourceImpl.h"
+#include "../CColShapeIndex.h"
 
 using namespace alt;
 
@@ -48,9 +49,10 @@ static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     Ref<ICheckpoint> cp = ICore::Instance().CreateCheckpoint(type, pos, radius, height, color);
 
-    if(cp) resource->BindEntity(info.This(), cp.Get());
-    else
-        V8Helpers::Throw(isolate, "Failed to create Checkpoint");
+    V8_CHECK(cp, "Failed to create Checkpoint");
+
+    resource->BindEntity(info.This(), cp.Get());
+    CColShapeIndex::Instance().Add(cp.As<IColShape>(), { pos[0] - radius, pos[1] - radius, pos[2] - height, pos[0] + radius, pos[1] + radius, pos[2] + height });
 }
 
 extern V8Class v8Colshape;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "V8Helpers.h"
+#include "V8Entity.h"
+
+namespace V8Helpers
+{
+    // Sends the event to the target of an emit to clients: null for every player, a player or an array of players.
+    // Throws and returns false if the target is invalid
+    inline bool TriggerClientEvent(
+      v8::Isolate* isolate, v8::Local<v8::Context> ctx, v8::Local<v8::Value> target, const std::string& eventName, alt::MValueArgs& args, const char* functionName)
+    {
+        if(target->IsNull())
+        {
+            alt::ICore::Instance().TriggerClientEventForAll(eventName, args);
+            return true;
+        }
+
+        if(target->IsArray())
+        {
+            v8::Local<v8::Array> arr = target.As<v8::Array>();
+            uint32_t length = arr->Length();
+            alt::Array<alt::Ref<alt::IPlayer>> targets;
+            targets.Reserve(length);
+
+            for(uint32_t i = 0; i < length; ++i)
+            {
+                v8::Local<v8::Value> ply;
+                V8_CHECK_RETN(arr->Get(ctx, i).ToLocal(&ply), std::string("Invalid player in ") + functionName + " players array", false);
+                V8Entity* v8Player = V8Entity::Get(ply);
+
+                V8_CHECK_RETN(v8Player && v8Player->GetHandle()->GetType() == alt::IBaseObject::Type::PLAYER, "player inside array expected", false);
+                targets.Push(v8Player->GetHandle().As<alt::IPlayer>());
+            }
+
+            alt::ICore::Instance().TriggerClientEvent(targets, eventName, args);
+            return true;
+        }
+
+        V8Entity* v8Player = V8Entity::Get(target);
+        V8_CHECK_RETN(v8Player && v8Player->GetHandle()->GetType() == alt::IBaseObject::Type::PLAYER, "player or null expected", false);
+
+        alt::ICore::Instance().TriggerClientEvent(v8Player->GetHandle().As<alt::IPlayer>(), eventName, args);
+        return true;
+    }
+}  // namespace V8Helpers
@@ -0,0 +1,76 @@
+#include "stdafx.h"
+
+#include "V8Helpers.h"
+#include "helpers/BindHelpers.h"
+#include "V8Class.h"
+#include "V8Entity.h"
+#include "V8ResourceImpl.h"
+#include "ClientEvent.h"
+
+using namespace alt;
+
+// Event arguments that were converted to MValues once and can be sent to clients
+// any number of times without converting them again
+struct ClientPayload
+{
+    std::string eventName;
+    MValueArgs args;
+    v8::Global<v8::Object> handle;
+};
+
+static void WeakCallback(const v8::WeakCallbackInfo<ClientPayload>& data)
+{
+    delete data.GetParameter();
+}
+
+static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT();
+    V8_CHECK_CONSTRUCTOR();
+    V8_CHECK_ARGS_LEN_MIN(1);
+
+    V8_ARG_TO_STRING(1, eventName);
+
+    ClientPayload* payload = new ClientPayload{ eventName.ToString() };
+    payload->args.Reserve(info.Length() - 1);
+    for(int i = 1; i < info.Length(); ++i) payload->args.Push(V8Helpers::V8ToMValue(info[i], false));
+
+    info.This()->SetInternalField(0, v8::External::New(isolate, payload));
+    payload->handle.Reset(isolate, info.This());
+    payload->handle.SetWeak(payload, WeakCallback, v8::WeakCallbackType::kParameter);
+}
+
+static void EventNameGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE();
+    V8_GET_THIS_INTERNAL_FIELD_EXTERNAL(1, payload, ClientPayload);
+
+    V8_RETURN_STD_STRING(payload->eventName);
+}
+
+static void Emit(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT();
+    V8_CHECK_ARGS_LEN(1);
+    V8_GET_THIS_INTERNAL_FIELD_EXTERNAL(1, payload, ClientPayload);
+
+    V8Helpers::TriggerClientEvent(isolate, ctx, info[0], payload->eventName, payload->args, "emit");
+}
+
+static void EmitAll(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE();
+    V8_GET_THIS_INTERNAL_FIELD_EXTERNAL(1, payload, ClientPayload);
+
+    ICore::Instance().TriggerClientEventForAll(payload->eventName, payload->args);
+}
+
+extern V8Class v8ClientPayload("ClientPayload", &Constructor, [](v8::Local<v8::FunctionTemplate> tpl) {
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    V8Helpers::SetAccessor(isolate, tpl, "eventName", EventNameGetter);
+
+    V8Helpers::SetMethod(isolate, tpl, "emit", Emit);
+    V8Helpers::SetMethod(isolate, tpl, "emitAll", EmitAll);
+});
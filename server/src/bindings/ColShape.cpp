@@ -3,9 +3,12 @@
 #include "V8Helpers.h"
 #include "helpers/BindHelpers.h"
 #include "V8ResourceImpl.h"
+#include "../CColShapeIndex.h"
 
 using namespace alt;
 
+static constexpr float Infinity = CColShapeIndex::Infinity;
+
 static void IsEntityIn(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT();
@@ -26,6 +29,61 @@ static void IsPointIn(const v8::FunctionCallbackInfo<v8::Value>& info)
     V8_RETURN_BOOLEAN(_this->IsPointIn(point));
 }
 
+static void PositionGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT_RESOURCE();
+    V8_GET_THIS_BASE_OBJECT(_this, IColShape);
+
+    V8_RETURN_VECTOR3(_this->GetPosition());
+}
+
+// Keeps the index up to date when colshapes are moved
+static void PositionSetter(v8::Local<v8::String>, v8::Local<v8::Value> val, const v8::PropertyCallbackInfo<void>& info)
+{
+    V8_GET_ISOLATE_CONTEXT();
+    V8_GET_THIS_BASE_OBJECT(_this, IColShape);
+    V8_TO_VECTOR3(val, pos);
+
+    _this->SetPosition(pos);
+    CColShapeIndex::Instance().Update(_this.Get());
+}
+
+static void ReturnColShapes(const v8::FunctionCallbackInfo<v8::Value>& info, V8ResourceImpl* resource, const std::vector<IColShape*>& shapes)
+{
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> ctx = isolate->GetEnteredOrMicrotaskContext();
+
+    v8::Local<v8::Array> arr = v8::Array::New(isolate, (int)shapes.size());
+    for(uint32_t i = 0; i < shapes.size(); i++) arr->Set(ctx, i, resource->GetBaseObjectOrNull(shapes[i]));
+    V8_RETURN(arr);
+}
+
+static void StaticQueryPoint(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT_RESOURCE();
+    V8_CHECK_ARGS_LEN(1);
+    V8_ARG_TO_VECTOR3(1, pos);
+    V8_CHECK(std::isfinite(pos[0]) && std::isfinite(pos[1]) && std::isfinite(pos[2]), "Position has to be finite");
+
+    std::vector<IColShape*> shapes;
+    CColShapeIndex::Instance().QueryPoint(pos, shapes);
+    ReturnColShapes(info, resource, shapes);
+}
+
+static void StaticQueryBoundsInRadius(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT_RESOURCE();
+    V8_CHECK_ARGS_LEN(2);
+    V8_ARG_TO_VECTOR3(1, pos);
+    V8_ARG_TO_NUMBER(2, radius);
+    V8_CHECK(std::isfinite(pos[0]) && std::isfinite(pos[1]) && std::isfinite(pos[2]), "Position has to be finite");
+    V8_CHECK(std::isfinite(radius) && radius >= 0, "Radius has to be a finite positive number");
+
+    std::vector<IColShape*> shapes;
+    CColShapeIndex::Instance().QueryBoundsInRadius(pos, (float)radius, shapes);
+    ReturnColShapes(info, resource, shapes);
+}
+
 extern V8Class v8WorldObject;
 extern V8Class v8Colshape("Colshape", v8WorldObject, nullptr, [](v8::Local<v8::FunctionTemplate> tpl) {
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
@@ -33,8 +91,15 @@ extern V8Class v8Colshape("Colshape", v8WorldObject, nullptr, [](v8::Local<v8::F
     V8Helpers::SetAccessor<IColShape, IColShape::ColShapeType, &IColShape::GetColshapeType>(isolate, tpl, "colshapeType");
     V8Helpers::SetAccessor<IColShape, bool, &IColShape::IsPlayersOnly, &IColShape::SetPlayersOnly>(isolate, tpl, "playersOnly");
 
+    V8Helpers::SetAccessor(isolate, tpl, "pos", &PositionGetter, &PositionSetter);
+
     V8Helpers::SetMethod(isolate, tpl, "isEntityIn", IsEntityIn);
     V8Helpers::SetMethod(isolate, tpl, "isPointIn", IsPointIn);
+
+    // Only colshapes created by JS resources are indexed.
+    // queryBoundsInRadius only tests the bounding boxes, check the results with isPointIn or isEntityIn where it matters
+    V8Helpers::SetStaticMethod(isolate, tpl, "queryPoint", StaticQueryPoint);
+    V8Helpers::SetStaticMethod(isolate, tpl, "queryBoundsInRadius", StaticQueryBoundsInRadius);
 });
 
 extern V8Class v8ColshapeCylinder(
@@ -54,6 +119,8 @@ extern V8Class v8ColshapeCylinder(
 
       Ref<IColShape> cs = ICore::Instance().CreateColShapeCylinder({ x, y, z }, radius, height);
       V8_CHECK(!cs.IsEmpty(), "Failed to create ColshapeCylinder");
+      // Whether the height goes up or is centered depends on the core, so cover both
+      CColShapeIndex::Instance().Add(cs, { (float)(x - radius), (float)(y - radius), (float)(z - height), (float)(x + radius), (float)(y + radius), (float)(z + height) });
 
       resource->BindEntity(info.This(), cs.Get());
   },
@@ -75,6 +142,7 @@ extern V8Class v8ColshapeSphere(
 
       Ref<IColShape> cs = alt::ICore::Instance().CreateColShapeSphere({ x, y, z }, radius);
       V8_CHECK(!cs.IsEmpty(), "Failed to create ColshapeSphere");
+      CColShapeIndex::Instance().Add(cs, { (float)(x - radius), (float)(y - radius), (float)(z - radius), (float)(x + radius), (float)(y + radius), (float)(z + radius) });
 
       resource->BindEntity(info.This(), cs.Get());
   },
@@ -95,6 +163,7 @@ extern V8Class v8ColshapeCircle(
 
       Ref<IColShape> cs = alt::ICore::Instance().CreateColShapeCircle({ x, y, 0 }, radius);
       V8_CHECK(!cs.IsEmpty(), "Failed to create ColshapeCircle");
+      CColShapeIndex::Instance().Add(cs, { (float)(x - radius), (float)(y - radius), -Infinity, (float)(x + radius), (float)(y + radius), Infinity });
 
       resource->BindEntity(info.This(), cs.Get());
   },
@@ -118,6 +187,8 @@ extern V8Class v8ColshapeCuboid(
 
       Ref<IColShape> cs = alt::ICore::Instance().CreateColShapeCube({ x1, y1, z1 }, { x2, y2, z2 });
       V8_CHECK(!cs.IsEmpty(), "Failed to create ColshapeCuboid");
+      CColShapeIndex::Instance().Add(
+        cs, { (float)std::min(x1, x2), (float)std::min(y1, y2), (float)std::min(z1, z2), (float)std::max(x1, x2), (float)std::max(y1, y2), (float)std::max(z1, z2) });
 
       resource->BindEntity(info.This(), cs.Get());
   },
@@ -139,6 +210,7 @@ extern V8Class v8ColshapeRectangle(
 
       Ref<IColShape> cs = alt::ICore::Instance().CreateColShapeRectangle(x1, y1, x2, y2, 0);
       V8_CHECK(!cs.IsEmpty(), "Failed to create ColshapeRectangle");
+      CColShapeIndex::Instance().Add(cs, { (float)std::min(x1, x2), (float)std::min(y1, y2), -Infinity, (float)std::max(x1, x2), (float)std::max(y1, y2), Infinity });
 
       resource->BindEntity(info.This(), cs.Get());
   },
@@ -171,6 +243,16 @@ extern V8Class v8ColshapePolygon(
       Ref<IColShape> cs = alt::ICore::Instance().CreateColShapePolygon(minZ, maxZ, points);
       V8_CHECK(!cs.IsEmpty(), "Failed to create ColShapePolygon");
 
+      CColShapeIndex::Bounds bounds{ Infinity, Infinity, (float)std::min(minZ, maxZ), -Infinity, -Infinity, (float)std::max(minZ, maxZ) };
+      for(Vector2f& point : points)
+      {
+          bounds.minX = std::min(bounds.minX, point[0]);
+          bounds.minY = std::min(bounds.minY, point[1]);
+          bounds.maxX = std::max(bounds.maxX, point[0]);
+          bounds.maxY = std::max(bounds.maxY, point[1]);
+      }
+      if(!points.empty()) CColShapeIndex::Instance().Add(cs, bounds);
+
       resource->BindEntity(info.This(), cs.Get());
   },
   [](v8::Local<v8::FunctionTemplate> tpl) {});
@@ -2,6 +2,7 @@
 
 #include "V8Module.h"
 #include "CNodeResourceImpl.h"
+#include "ClientEvent.h"
 
 using namespace alt;
 
@@ -14,14 +15,14 @@ static void OnClient(const v8::FunctionCallbackInfo<v8::Value>& info)
     {
         V8_ARG_TO_FUNCTION(1, callback);
 
-        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::GetCurrent(isolate));
+        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::Capture(isolate));
     }
     else if(info.Length() == 2)
     {
         V8_ARG_TO_STRING(1, eventName);
         V8_ARG_TO_FUNCTION(2, callback);
 
-        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::GetCurrent(isolate));
+        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::Capture(isolate));
     }
 }
 
@@ -34,14 +35,14 @@ static void OnceClient(const v8::FunctionCallbackInfo<v8::Value>& info)
     {
         V8_ARG_TO_FUNCTION(1, callback);
 
-        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+        resource->SubscribeGenericRemote(callback, V8Helpers::SourceLocation::Capture(isolate), true);
     }
     else if(info.Length() == 2)
     {
         V8_ARG_TO_STRING(1, eventName);
         V8_ARG_TO_FUNCTION(2, callback);
 
-        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+        resource->SubscribeRemote(eventName.ToString(), callback, V8Helpers::SourceLocation::Capture(isolate), true);
     }
 }
 
@@ -76,41 +77,7 @@ static void EmitClient(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     for(int i = 2; i < info.Length(); ++i) mvArgs.Push(V8Helpers::V8ToMValue(info[i], false));
 
-    if(info[0]->IsNull())
-    {
-        // if first argument is null this event gets send to every player
-        ICore::Instance().TriggerClientEventForAll(eventName.ToString(), mvArgs);
-        return;
-    }
-
-    if(info[0]->IsArray())
-    {
-        // if first argument is an array of players this event will be sent to every player in array
-        v8::Local<v8::Array> arr = info[0].As<v8::Array>();
-        Array<Ref<IPlayer>> targets;
-        targets.Reserve(arr->Length());
-
-        for(int i = 0; i < arr->Length(); ++i)
-        {
-            Ref<IPlayer> player;
-            v8::Local<v8::Value> ply;
-            V8_CHECK(arr->Get(ctx, i).ToLocal(&ply), "Invalid player in emitClient players array");
-            V8Entity* v8Player = V8Entity::Get(ply);
-
-            V8_CHECK(v8Player && v8Player->GetHandle()->GetType() == alt::IBaseObject::Type::PLAYER, "player inside array expected");
-            targets.Push(v8Player->GetHandle().As<IPlayer>());
-        }
-
-        ICore::Instance().TriggerClientEvent(targets, eventName.ToString(), mvArgs);
-    }
-    else
-    {
-        // if first argument is not null and not an array this event gets sent to the specific player
-        V8Entity* v8Player = V8Entity::Get(info[0]);
-        V8_CHECK(v8Player && v8Player->GetHandle()->GetType() == alt::IBaseObject::Type::PLAYER, "player or null expected");
-
-        ICore::Instance().TriggerClientEvent(v8Player->GetHandle().As<IPlayer>(), eventName.ToString(), mvArgs);
-    }
+    V8Helpers::TriggerClientEvent(isolate, ctx, info[0], eventName.ToString(), mvArgs, "emitClient");
 }
 
 static void EmitAllClients(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -126,6 +93,19 @@ static void EmitAllClients(const v8::FunctionCallbackInfo<v8::Value>& info)
     ICore::Instance().TriggerClientEventForAll(eventName, args);
 }
 
+extern V8Class v8ClientPayload;
+static void CreateClientPayload(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT();
+    V8_CHECK_ARGS_LEN_MIN(1);
+
+    std::vector<v8::Local<v8::Value>> args;
+    args.reserve(info.Length());
+    for(int i = 0; i < info.Length(); ++i) args.push_back(info[i]);
+
+    V8_RETURN(v8ClientPayload.New(ctx, args));
+}
+
 static void EmitClientRaw(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT();
@@ -148,41 +128,7 @@ static void EmitClientRaw(const v8::FunctionCallbackInfo<v8::Value>& info)
         mvArgs.Push(result);
     }
 
-    if(info[0]->IsNull())
-    {
-        // if first argument is null this event gets send to every player
-        ICore::Instance().TriggerClientEventForAll(eventName.ToString(), mvArgs);
-        return;
-    }
-
-    if(info[0]->IsArray())
-    {
-        // if first argument is an array of players this event will be sent to every player in array
-        v8::Local<v8::Array> arr = info[0].As<v8::Array>();
-        Array<Ref<IPlayer>> targets;
-        targets.Reserve(arr->Length());
-
-        for(int i = 0; i < arr->Length(); ++i)
-        {
-            Ref<IPlayer> player;
-            v8::Local<v8::Value> ply;
-            V8_CHECK(arr->Get(ctx, i).ToLocal(&ply), "Invalid player in emitClient players array");
-            V8Entity* v8Player = V8Entity::Get(ply);
-
-            V8_CHECK(v8Player && v8Player->GetHandle()->GetType() == alt::IBaseObject::Type::PLAYER, "player inside array expected");
-            targets.Push(v8Player->GetHandle().As<IPlayer>());
-        }
-
-        ICore::Instance().TriggerClientEvent(targets, eventName.ToString(), mvArgs);
-    }
-    else
-    {
-        // if first argument is not null and not an array this event gets sent to the specific player
-        V8Entity* v8Player = V8Entity::Get(info[0]);
-        V8_CHECK(v8Player && v8Player->GetHandle()->GetType() == alt::IBaseObject::Type::PLAYER, "player or null expected");
-
-        ICore::Instance().TriggerClientEvent(v8Player->GetHandle().As<IPlayer>(), eventName.ToString(), mvArgs);
-    }
+    V8Helpers::TriggerClientEvent(isolate, ctx, info[0], eventName.ToString(), mvArgs, "emitClientRaw");
 }
 
 static void EmitAllClientsRaw(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -388,7 +334,7 @@ static void GetServerConfig(const v8::FunctionCallbackInfo<v8::Value>& info)
 }
 
 extern V8Class v8Player, v8Vehicle, v8Blip, v8AreaBlip, v8RadiusBlip, v8PointBlip, v8Checkpoint, v8VoiceChannel, v8Colshape, v8ColshapeCylinder, v8ColshapeSphere, v8ColshapeCircle,
-  v8ColshapeCuboid, v8ColshapeRectangle, v8ColshapePolygon;
+  v8ColshapeCuboid, v8ColshapeRectangle, v8ColshapePolygon, v8ClientPayload;
 
 extern V8Module sharedModule;
 
@@ -409,7 +355,8 @@ extern V8Module v8Alt("alt",
                         v8ColshapeCircle,
                         v8ColshapeCuboid,
                         v8ColshapeRectangle,
-                        v8ColshapePolygon },
+                        v8ColshapePolygon,
+                        v8ClientPayload },
                       [](v8::Local<v8::Context> ctx, v8::Local<v8::Object> exports) {
                           v8::Isolate* isolate = ctx->GetIsolate();
 
@@ -425,6 +372,7 @@ extern V8Module v8Alt("alt",
                           V8Helpers::RegisterFunc(exports, "offClient", &OffClient);
                           V8Helpers::RegisterFunc(exports, "emitClient", &EmitClient);
                           V8Helpers::RegisterFunc(exports, "emitAllClients", &EmitAllClients);
+                          V8Helpers::RegisterFunc(exports, "createClientPayload", &CreateClientPayload);
                           V8Helpers::RegisterFunc(exports, "emitClientRaw", &EmitClientRaw);
                           V8Helpers::RegisterFunc(exports, "emitAllClientsRaw", &EmitAllClientsRaw);
 
@@ -377,6 +377,11 @@ static void AllGetter(v8::Local<v8::String> name, const v8::PropertyCallbackInfo
     V8_RETURN(resource->GetAllPlayers());
 }
 
+static void StaticGetTransforms(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8Helpers::GetTransforms(info, alt::ICore::Instance().GetPlayers());
+}
+
 static void StaticGetByID(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT_RESOURCE();
@@ -737,6 +742,7 @@ extern V8Class v8Player("Player", v8Entity, nullptr, [](v8::Local<v8::FunctionTe
     v8::Local<v8::ObjectTemplate> proto = tpl->PrototypeTemplate();
 
     V8Helpers::SetStaticMethod(isolate, tpl, "getByID", &StaticGetByID);
+    V8Helpers::SetStaticMethod(isolate, tpl, "getTransforms", &StaticGetTransforms);
     V8Helpers::SetStaticAccessor(isolate, tpl, "all", &AllGetter);
 
     V8Helpers::SetMethod(isolate, tpl, "emit", &Emit);
@@ -71,6 +71,11 @@ static void AllGetter(v8::Local<v8::String> name, const v8::PropertyCallbackInfo
     V8_RETURN(resource->GetAllVehicles());
 }
 
+static void StaticGetTransforms(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8Helpers::GetTransforms(info, alt::ICore::Instance().GetVehicles());
+}
+
 static void StaticGetByID(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT_RESOURCE();
@@ -157,6 +162,7 @@ extern V8Class v8Vehicle("Vehicle", v8Entity, Constructor, [](v8::Local<v8::Func
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
 
     V8Helpers::SetStaticMethod(isolate, tpl, "getByID", StaticGetByID);
+    V8Helpers::SetStaticMethod(isolate, tpl, "getTransforms", StaticGetTransforms);
     V8Helpers::SetStaticAccessor(isolate, tpl, "all", AllGetter);
 
     // Common getter/setters
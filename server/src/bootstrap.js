@@ -50,7 +50,7 @@
     });
 
     // Load the global bindings code
-    new Function("alt", __internal_bindings_code)(alt);
+    __internal_bindings(alt);
 
     // Get the path to the main file for this resource, and load it
     const _path = path.resolve(resource.path, resource.main);
@@ -17,7 +17,7 @@ using EventType = CEvent::Type;
 
 V8Helpers::EventHandler clientScriptEvent(
   EventType::CLIENT_SCRIPT_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CClientScriptEvent*>(e);
       return resource->GetRemoteHandlers(ev->GetName().ToString());
   },
@@ -30,7 +30,7 @@ V8Helpers::EventHandler clientScriptEvent(
 
 V8Helpers::EventHandler serverScriptEvent(
   EventType::SERVER_SCRIPT_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
       auto ev = static_cast<const alt::CServerScriptEvent*>(e);
       return resource->GetLocalHandlers(ev->GetName().ToString());
   },
@@ -41,12 +41,14 @@ V8Helpers::EventHandler serverScriptEvent(
 
 V8Helpers::EventHandler colshapeEvent(
   EventType::COLSHAPE_EVENT,
-  [](V8ResourceImpl* resource, const CEvent* e) {
+  [](V8ResourceImpl* resource, const CEvent* e) -> const std::vector<V8Helpers::EventCallback*>& {
+      static V8Helpers::EventNames::Id enterId = V8Helpers::EventNames::Intern("entityEnterColshape");
+      static V8Helpers::EventNames::Id leaveId = V8Helpers::EventNames::Intern("entityLeaveColshape");
       auto ev = static_cast<const alt::CColShapeEvent*>(e);
 
-      if(ev->GetState()) return resource->GetLocalHandlers("entityEnterColshape");
+      if(ev->GetState()) return resource->GetLocalHandlers(enterId);
       else
-          return resource->GetLocalHandlers("entityLeaveColshape");
+          return resource->GetLocalHandlers(leaveId);
   },
   [](V8ResourceImpl* resource, const CEvent* e, std::vector<v8::Local<v8::Value>>& args) {
       auto ev = static_cast<const alt::CColShapeEvent*>(e);
@@ -4,6 +4,7 @@
 
 #include "V8Module.h"
 #include "CNodeScriptRuntime.h"
+#include "CTracer.h"
 
 /*static void NodeStop()
 {
@@ -76,6 +77,33 @@ static void CommandHandler(const std::vector<std::string>& args)
         Log::Colored << "~y~Options:" << Log::Endl;
         Log::Colored << "  ~ly~--help    ~w~- this message." << Log::Endl;
         Log::Colored << "  ~ly~--version ~w~- version info." << Log::Endl;
+        Log::Colored << "  ~ly~stats     ~w~- time and heap usage of every resource." << Log::Endl;
+        Log::Colored << "  ~ly~trace     ~w~- start tracing, or stop and dump the trace if it is running." << Log::Endl;
+    }
+    else if(args[0] == "trace")
+    {
+        CTracer& tracer = CTracer::Instance();
+        if(!tracer.IsEnabled())
+        {
+            tracer.SetIsEnabled(true);
+            tracer.SetThreadName("Main");
+            Log::Colored << "[Tracer] ~lg~Started tracing" << Log::Endl;
+        }
+        else
+        {
+            tracer.SetIsEnabled(false);
+            tracer.Dump("./");
+        }
+    }
+    else if(args[0] == "stats")
+    {
+        auto resources = CNodeScriptRuntime::Instance().GetResources();
+        Log::Info << "================ Resource stats =================" << Log::Endl;
+        for(auto resource : resources)
+        {
+            if(resource->IsEnvStarted()) resource->LogStats();
+        }
+        Log::Info << "======================================================" << Log::Endl;
     }
 }
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+// Log-linear histogram in the style of HdrHistogram.
+// Values are grouped by their highest set bit and every group is split into SubBuckets linear buckets,
+// so the relative error of the reported values stays below 1 / SubBuckets while the memory stays fixed.
+// Recording is lock-free and never allocates, so it can be used from any thread.
+class CHistogram
+{
+public:
+    static constexpr uint32_t SubBucketBits = 5;
+    static constexpr uint32_t SubBuckets = 1 << SubBucketBits;
+    // Values below SubBuckets are stored exactly, every following bit adds another group
+    static constexpr uint32_t BucketCount = SubBuckets + (64 - SubBucketBits) * SubBuckets;
+
+private:
+    std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+    std::atomic<uint64_t> count = 0;
+    std::atomic<uint64_t> sum = 0;
+    std::atomic<uint64_t> min = std::numeric_limits<uint64_t>::max();
+    std::atomic<uint64_t> max = 0;
+
+    static uint32_t GetHighestBit(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return (uint32_t)index;
+#else
+        return 63 - (uint32_t)__builtin_clzll(value);
+#endif
+    }
+
+    static uint32_t GetBucketIndex(uint64_t value)
+    {
+        if(value < SubBuckets) return (uint32_t)value;
+
+        uint32_t shift = GetHighestBit(value) - SubBucketBits;
+        uint32_t subBucket = (uint32_t)(value >> shift) - SubBuckets;
+        return SubBuckets + shift * SubBuckets + subBucket;
+    }
+
+    // Highest value that is stored in the bucket
+    static uint64_t GetBucketValue(uint32_t index)
+    {
+        if(index < SubBuckets) return index;
+
+        uint32_t shift = (index - SubBuckets) / SubBuckets;
+        uint64_t subBucket = SubBuckets + (index - SubBuckets) % SubBuckets;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+public:
+    void Record(uint64_t value)
+    {
+        buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current = min.load(std::memory_order_relaxed);
+        while(value < current && !min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        current = max.load(std::memory_order_relaxed);
+        while(value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t GetCount() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+    uint64_t GetMin() const
+    {
+        return GetCount() == 0 ? 0 : min.load(std::memory_order_relaxed);
+    }
+    uint64_t GetMax() const
+    {
+        return max.load(std::memory_order_relaxed);
+    }
+    double GetMean() const
+    {
+        uint64_t total = GetCount();
+        return total == 0 ? 0 : (double)sum.load(std::memory_order_relaxed) / total;
+    }
+
+    // Returns the value below which the given percentage (0 - 100) of the recorded values are
+    uint64_t GetPercentile(double percentile) const
+    {
+        uint64_t total = GetCount();
+        if(total == 0) return 0;
+
+        uint64_t target = (uint64_t)(percentile / 100.0 * total + 0.5);
+        if(target == 0) target = 1;
+
+        uint64_t seen = 0;
+        for(uint32_t i = 0; i < BucketCount; i++)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if(seen >= target)
+            {
+                uint64_t value = GetBucketValue(i);
+                uint64_t maxValue = GetMax();
+                return value > maxValue ? maxValue : value;
+            }
+        }
+        return GetMax();
+    }
+};
@@ -1,7 +1,8 @@
 #pragma once
 
-#include <unordered_map>
-#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
 #include <chrono>
 #include <ctime>
 #include <sstream>
@@ -10,38 +11,77 @@
 #include <filesystem>
 
 #include "Log.h"
+#include "CHistogram.h"
+#include "CTracer.h"
 
 class CProfiler
 {
-    using Duration = std::chrono::high_resolution_clock::duration;
-    using TimePoint = std::chrono::high_resolution_clock::time_point;
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::string name;
+        // Durations in nanoseconds
+        CHistogram histogram;
+
+        Entry(const std::string& _name) : name(_name) {}
+    };
 
     bool enabled = false;
     bool logsEnabled = true;
-    std::unordered_multimap<std::string, Duration> samples;
-    std::unordered_map<std::string, TimePoint> runningSamples;
 
-    void StartSample(const std::string& name)
-    {
-        if(!enabled) return;
-        runningSamples.insert({ name, std::chrono::high_resolution_clock::now() });
-    }
-    void EndSample(const std::string& name, bool skipLog)
+    static constexpr uint32_t MaxEntries = 256;
+
+    // Entries are never moved or removed, so recording doesn't need the lock
+    std::mutex entriesLock;
+    std::array<std::unique_ptr<Entry>, MaxEntries> entries;
+    std::atomic<uint32_t> entriesCount = 0;
+
+    void Record(uint32_t id, Clock::time_point start, Clock::time_point end, bool skipLog)
     {
-        if(!enabled) return;
-        auto it = runningSamples.find(name);
-        if(it == runningSamples.end()) return;
-        Duration duration = std::chrono::high_resolution_clock::now() - it->second;
-        samples.insert({ name, duration });
-        runningSamples.erase(it);
+        if(id >= entriesCount.load(std::memory_order_acquire)) return;
+        Entry* entry = entries[id].get();
+        Clock::duration duration = end - start;
+
+        CTracer& tracer = CTracer::Instance();
+        if(tracer.IsEnabled())
+        {
+            using namespace std::chrono;
+            tracer.Record("profiler", entry->name, {}, duration_cast<microseconds>(start.time_since_epoch()).count(), duration_cast<microseconds>(end.time_since_epoch()).count());
+        }
+
+        entry->histogram.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
 
         if(skipLog || !logsEnabled) return;
-        float ms = duration.count() / 1000000.f;
+        float ms = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1000000.f;
         std::string color = ms > 50 ? "~lr~" : ms > 20 ? "~ly~" : "~lg~";
-        Log::Colored << "[Profiler] ~lc~" << name << "~w~ took: " << color << ms << "ms" << Log::Endl;
+        Log::Colored << "[Profiler] ~lc~" << entry->name << "~w~ took: " << color << ms << "ms" << Log::Endl;
     }
 
 public:
+    using Id = uint32_t;
+
+    // Returns the id of the sample with the given name, registering it if needed.
+    // Register the names once up front and keep the ids, so taking a sample doesn't have to look them up
+    Id Register(const std::string& name)
+    {
+        std::scoped_lock lock(entriesLock);
+        uint32_t count = entriesCount.load(std::memory_order_relaxed);
+        for(Id i = 0; i < count; i++)
+        {
+            if(entries[i]->name == name) return i;
+        }
+        if(count == MaxEntries)
+        {
+            Log::Error << "[Profiler] Too many samples registered, ignoring " << name << Log::Endl;
+            return MaxEntries;
+        }
+
+        entries[count] = std::make_unique<Entry>(name);
+        entriesCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
     void Dump(const std::string& path)
     {
         if(!enabled) return;
@@ -57,7 +97,7 @@ public:
 #endif
         std::ostringstream stream;
         stream << std::put_time(&time, "%d-%m-%Y %H-%M-%S");
-        std::filesystem::path filePath = path / std::filesystem::path(stream.str() + ".samples");
+        std::filesystem::path filePath = path / std::filesystem::path(stream.str() + ".profile.json");
 
         std::ofstream file(filePath.string());
         if(!file.good())
@@ -67,19 +107,27 @@ public:
             return;
         }
 
-        for(auto it = samples.begin(), end = samples.end(); it != end; it = samples.equal_range(it->first).second)
+        // All times are in nanoseconds
+        std::scoped_lock lock(entriesLock);
+        file << "[\n";
+        bool first = true;
+        for(uint32_t i = 0, count = entriesCount.load(std::memory_order_relaxed); i < count; i++)
         {
-            file << it->first << ' ';
-            auto items = samples.equal_range(it->first);
-            auto lastItem = std::prev(items.second);
-            for(auto i = items.first; i != items.second; ++i)
-            {
-                file << i->second.count();
-                if(i != lastItem) file << ',';
-            }
-
-            file << '\n';
+            Entry* entry = entries[i].get();
+            const CHistogram& histogram = entry->histogram;
+            if(histogram.GetCount() == 0) continue;
+
+            if(!first) file << ",\n";
+            first = false;
+            file << "    { \"name\": \"" << entry->name << "\", \"samples\": " << histogram.GetCount() << ", \"min\": " << histogram.GetMin() << ", \"max\": " << histogram.GetMax()
+                 << ", \"avg\": " << (uint64_t)histogram.GetMean() << ", \"p50\": " << histogram.GetPercentile(50) << ", \"p90\": " << histogram.GetPercentile(90)
+                 << ", \"p99\": " << histogram.GetPercentile(99) << " }";
+
+            Log::Colored << "[Profiler] ~lc~" << entry->name << "~w~ | Samples: " << histogram.GetCount() << " | p50: " << histogram.GetPercentile(50) / 1000000.f
+                         << "ms | p90: " << histogram.GetPercentile(90) / 1000000.f << "ms | p99: " << histogram.GetPercentile(99) / 1000000.f
+                         << "ms | Max: " << histogram.GetMax() / 1000000.f << "ms" << Log::Endl;
         }
+        file << "\n]\n";
 
         file.close();
         Log::Colored << "[Profiler] Dumped samples to ~lc~" << filePath.string() << Log::Endl;
@@ -110,17 +158,19 @@ public:
 
     class Sample
     {
-        std::string name;
+        Id id;
         bool skipLog;
+        Clock::time_point start;
 
     public:
-        Sample(const std::string& _name, bool _skipLog = false) : name(_name), skipLog(_skipLog)
+        Sample(Id _id, bool _skipLog = false) : id(_id), skipLog(_skipLog)
         {
-            Instance().StartSample(name);
+            if(Instance().IsEnabled()) start = Clock::now();
         }
         ~Sample()
         {
-            Instance().EndSample(name, skipLog);
+            // Samples that started while the profiler was disabled are skipped
+            if(Instance().IsEnabled() && start != Clock::time_point{}) Instance().Record(id, start, Clock::now(), skipLog);
         }
     };
 };
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+// Runs blocking work like file reads off the main thread. Tasks must not touch V8,
+// results are handed back to the resource with its async callback queue
+class CThreadPool
+{
+    using Task = std::function<void()>;
+
+    std::mutex lock;
+    std::condition_variable condition;
+    std::deque<Task> tasks;
+    bool threadsStarted = false;
+
+    void Thread()
+    {
+        while(true)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                condition.wait(guard, [this]() { return !tasks.empty(); });
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    static CThreadPool& Instance()
+    {
+        // Never destroyed, the threads still wait on it when the process exits
+        static CThreadPool* instance = new CThreadPool();
+        return *instance;
+    }
+
+    void Run(Task&& task)
+    {
+        std::scoped_lock guard(lock);
+        if(!threadsStarted)
+        {
+            // Tasks mostly wait for the disk, a few threads are enough to keep it busy
+            uint32_t threadCount = std::clamp(std::thread::hardware_concurrency() / 2, 2u, 4u);
+            for(uint32_t i = 0; i < threadCount; i++) std::thread(&CThreadPool::Thread, this).detach();
+            threadsStarted = true;
+        }
+
+        tasks.push_back(std::move(task));
+        condition.notify_one();
+    }
+};
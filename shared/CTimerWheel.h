@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Hashed hierarchical timer wheel with millisecond resolution.
+// Every level has 64 slots, a timer is stored in the lowest level whose range covers its deadline
+// and gets cascaded down into a finer level once the wheel reaches the block it is stored in,
+// so advancing the wheel only ever touches timers that are about to expire.
+class CTimerWheel
+{
+public:
+    using TimerId = uint32_t;
+
+    static constexpr uint32_t SlotBits = 6;
+    static constexpr uint32_t SlotCount = 1 << SlotBits;
+    static constexpr uint32_t SlotMask = SlotCount - 1;
+    static constexpr uint32_t LevelCount = 6;
+
+private:
+    struct Entry
+    {
+        TimerId id;
+        int64_t deadline;
+    };
+    using Slot = std::vector<Entry>;
+
+    std::array<std::array<Slot, SlotCount>, LevelCount> levels;
+    // Timers that are already due when scheduled, they are returned on the next advance
+    Slot pending;
+    Slot cascadeBuffer;
+    int64_t current;
+    size_t size = 0;
+
+    static constexpr int64_t GetLevelRange(uint32_t level)
+    {
+        return int64_t(1) << (SlotBits * (level + 1));
+    }
+
+    static constexpr uint32_t GetSlotIndex(int64_t time, uint32_t level)
+    {
+        return uint32_t(time >> (SlotBits * level)) & SlotMask;
+    }
+
+    void Insert(const Entry& entry)
+    {
+        int64_t delta = entry.deadline - current;
+        for(uint32_t level = 0; level < LevelCount; level++)
+        {
+            if(delta < GetLevelRange(level))
+            {
+                levels[level][GetSlotIndex(entry.deadline, level)].push_back(entry);
+                return;
+            }
+        }
+
+        // Deadline is out of range of the wheel, park it in the last slot reachable by the top level,
+        // it gets re-inserted with its real deadline once that slot is cascaded
+        int64_t parkTime = current + GetLevelRange(LevelCount - 1) - 1;
+        levels[LevelCount - 1][GetSlotIndex(parkTime, LevelCount - 1)].push_back(entry);
+    }
+
+    // Moves all timers of the current slot of the specified level down into the lower levels,
+    // returns whether the next level has to be cascaded too
+    bool Cascade(uint32_t level)
+    {
+        uint32_t idx = GetSlotIndex(current, level);
+        cascadeBuffer.swap(levels[level][idx]);
+        for(const Entry& entry : cascadeBuffer) Insert(entry);
+        cascadeBuffer.clear();
+        return idx == 0;
+    }
+
+public:
+    CTimerWheel(int64_t time) : current(time) {}
+
+    CTimerWheel(const CTimerWheel&) = delete;
+    CTimerWheel& operator=(const CTimerWheel&) = delete;
+
+    void Schedule(TimerId id, int64_t deadline)
+    {
+        if(deadline <= current) pending.push_back(Entry{ id, deadline });
+        else
+            Insert(Entry{ id, deadline });
+        size++;
+    }
+
+    // Advances the wheel to the specified time and appends the ids of all
+    // expired timers to the output, ordered by their deadline
+    void Advance(int64_t time, std::vector<TimerId>& expired)
+    {
+        for(const Entry& entry : pending) expired.push_back(entry.id);
+        size -= pending.size();
+        pending.clear();
+
+        if(size == 0)
+        {
+            if(time > current) current = time;
+            return;
+        }
+
+        while(current < time)
+        {
+            current++;
+
+            uint32_t idx = GetSlotIndex(current, 0);
+            if(idx == 0)
+            {
+                for(uint32_t level = 1; level < LevelCount && Cascade(level); level++)
+                    ;
+            }
+
+            Slot& slot = levels[0][idx];
+            if(slot.empty()) continue;
+
+            for(const Entry& entry : slot) expired.push_back(entry.id);
+            size -= slot.size();
+            slot.clear();
+
+            if(size == 0)
+            {
+                current = time;
+                break;
+            }
+        }
+    }
+
+    void Clear(int64_t time)
+    {
+        for(auto& level : levels)
+        {
+            for(Slot& slot : level) slot.clear();
+        }
+        pending.clear();
+        size = 0;
+        current = time;
+    }
+
+    int64_t GetCurrentTime() const
+    {
+        return current;
+    }
+
+    // Amount of scheduled entries, including entries of timers that were removed but not yet expired
+    size_t GetSize() const
+    {
+        return size;
+    }
+};
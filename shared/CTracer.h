@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+#include <string_view>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <filesystem>
+
+#include "Log.h"
+
+// Records what the module is doing as spans in the Chrome Trace Event format, viewable in chrome://tracing or Perfetto.
+// Every thread writes into its own fixed-size ring buffer, so recording a span never locks or allocates
+// and only the latest spans are kept while tracing is enabled.
+class CTracer
+{
+public:
+    static constexpr size_t BufferSize = 16384;
+    static constexpr size_t NameSize = 48;
+    static constexpr size_t ResourceSize = 24;
+
+    static int64_t GetTime()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    struct Event
+    {
+        // Index of the write + 1, 0 while the event is being written
+        std::atomic<uint64_t> sequence = 0;
+        const char* category;
+        int64_t start;
+        int64_t duration;
+        uint32_t threadId;
+        char name[NameSize];
+        char resource[ResourceSize];
+    };
+
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Event[]> events{ new Event[BufferSize] };
+        std::atomic<uint64_t> written = 0;
+        // Buffers of exited threads are reused by new threads, their events are kept until overwritten
+        bool inUse = true;
+        uint32_t threadId = 0;
+        std::string threadName;
+    };
+
+    // Releases the buffer of the thread when it exits
+    struct ThreadHandle
+    {
+        ThreadBuffer* buffer = nullptr;
+
+        ~ThreadHandle()
+        {
+            if(!buffer) return;
+            std::scoped_lock lock(Instance().buffersLock);
+            buffer->inUse = false;
+        }
+    };
+
+    std::atomic<bool> enabled = false;
+    std::mutex buffersLock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+    uint32_t nextThreadId = 1;
+
+    static ThreadHandle& GetThreadHandle()
+    {
+        static thread_local ThreadHandle handle;
+        return handle;
+    }
+
+    ThreadBuffer* GetThreadBuffer()
+    {
+        ThreadHandle& handle = GetThreadHandle();
+        if(handle.buffer) return handle.buffer;
+
+        std::scoped_lock lock(buffersLock);
+        for(auto& buffer : buffers)
+        {
+            if(buffer->inUse) continue;
+            handle.buffer = buffer.get();
+            break;
+        }
+        if(!handle.buffer) handle.buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+
+        handle.buffer->inUse = true;
+        handle.buffer->threadId = nextThreadId++;
+        threadNames.push_back({ handle.buffer->threadId, "Thread " + std::to_string(handle.buffer->threadId) });
+        return handle.buffer;
+    }
+
+    static void Copy(char* target, size_t size, std::string_view value)
+    {
+        size_t length = value.size() < size - 1 ? value.size() : size - 1;
+        memcpy(target, value.data(), length);
+        target[length] = '\0';
+    }
+
+    static void WriteString(std::ostream& stream, const char* value)
+    {
+        stream << '"';
+        for(const char* c = value; *c; c++)
+        {
+            if(*c == '"' || *c == '\\') stream << '\\' << *c;
+            else if((unsigned char)*c < 0x20)
+                stream << ' ';
+            else
+                stream << *c;
+        }
+        stream << '"';
+    }
+
+public:
+    bool IsEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    void SetIsEnabled(bool state)
+    {
+        enabled = state;
+    }
+
+    // Names the calling thread in the trace
+    void SetThreadName(const std::string& name)
+    {
+        ThreadBuffer* buffer = GetThreadBuffer();
+        std::scoped_lock lock(buffersLock);
+        for(auto& [id, threadName] : threadNames)
+        {
+            if(id == buffer->threadId) threadName = name;
+        }
+    }
+
+    // Category has to be a string literal, the name and resource are copied
+    void Record(const char* category, std::string_view name, std::string_view resource, int64_t start, int64_t end)
+    {
+        if(!IsEnabled()) return;
+
+        ThreadBuffer* buffer = GetThreadBuffer();
+        uint64_t index = buffer->written.load(std::memory_order_relaxed);
+        Event& event = buffer->events[index % BufferSize];
+
+        event.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        event.category = category;
+        event.start = start;
+        event.duration = end - start;
+        event.threadId = buffer->threadId;
+        Copy(event.name, NameSize, name);
+        Copy(event.resource, ResourceSize, resource);
+        event.sequence.store(index + 1, std::memory_order_release);
+
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+
+    void Dump(const std::string& path)
+    {
+        int64_t t = std::time(nullptr);
+        std::tm time;
+#if defined(__unix__)
+        localtime_r(&t, &time);
+#elif defined(_MSC_VER)
+        localtime_s(&time, &t);
+#else
+        time = *std::localtime(&t);
+#endif
+        std::ostringstream stream;
+        stream << std::put_time(&time, "%d-%m-%Y %H-%M-%S");
+        std::filesystem::path filePath = path / std::filesystem::path(stream.str() + ".trace.json");
+
+        std::ofstream file(filePath.string());
+        if(!file.good())
+        {
+            Log::Error << "[Tracer] Failed to dump trace" << Log::Endl;
+            file.close();
+            return;
+        }
+
+        std::scoped_lock lock(buffersLock);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for(auto& [id, name] : threadNames)
+        {
+            if(!first) file << ",\n";
+            first = false;
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << id << ",\"args\":{\"name\":";
+            WriteString(file, name.c_str());
+            file << "}}";
+        }
+
+        size_t count = 0;
+        Event event;
+        for(auto& buffer : buffers)
+        {
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            for(uint64_t i = written > BufferSize ? written - BufferSize : 0; i < written; i++)
+            {
+                // The owning thread might be overwriting the event right now, skip it if it changed while copying
+                Event& source = buffer->events[i % BufferSize];
+                if(source.sequence.load(std::memory_order_acquire) != i + 1) continue;
+                event.category = source.category;
+                event.start = source.start;
+                event.duration = source.duration;
+                event.threadId = source.threadId;
+                memcpy(event.name, source.name, NameSize);
+                memcpy(event.resource, source.resource, ResourceSize);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(source.sequence.load(std::memory_order_relaxed) != i + 1) continue;
+                event.name[NameSize - 1] = '\0';
+                event.resource[ResourceSize - 1] = '\0';
+
+                if(!first) file << ",\n";
+                first = false;
+                file << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << ",\"cat\":\"" << event.category
+                     << "\",\"name\":";
+                WriteString(file, event.name);
+                if(event.resource[0] != '\0')
+                {
+                    file << ",\"args\":{\"resource\":";
+                    WriteString(file, event.resource);
+                    file << "}";
+                }
+                file << "}";
+                count++;
+            }
+        }
+        file << "\n]}\n";
+
+        file.close();
+        Log::Colored << "[Tracer] Dumped " << count << " events to ~lc~" << filePath.string() << Log::Endl;
+    }
+
+    static CTracer& Instance()
+    {
+        static CTracer instance;
+        return instance;
+    }
+
+    // Records the time until the scope is left
+    class Scope
+    {
+        const char* category;
+        std::string_view name;
+        std::string_view resource;
+        int64_t start = 0;
+
+    public:
+        // The name and resource have to stay valid until the scope is left
+        Scope(const char* _category, std::string_view _name, std::string_view _resource = {}) : category(_category), name(_name), resource(_resource)
+        {
+            if(Instance().IsEnabled()) start = GetTime();
+        }
+        ~Scope()
+        {
+            if(start != 0) Instance().Record(category, name, resource, start, GetTime());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "v8.h"
+
+// Terminates script executions that run longer than their time limit, so an endless loop
+// in a script doesn't freeze the whole tick. One thread watches the executions of all isolates.
+// Watching an execution only stores its deadline in the slot of the isolate, which the thread polls
+class CWatchdog
+{
+    using Clock = std::chrono::steady_clock;
+
+    // How often the thread checks the deadlines, executions are terminated at most this much later
+    static constexpr auto PollInterval = std::chrono::milliseconds(10);
+
+    // Deadline values that are not a time
+    static constexpr int64_t Unarmed = 0;
+    static constexpr int64_t Terminating = -1;
+    static constexpr int64_t Terminated = -2;
+
+    struct Slot
+    {
+        v8::Isolate* isolate;
+        // Milliseconds of the steady clock
+        std::atomic<int64_t> deadline{ Unarmed };
+    };
+
+    std::mutex lock;
+    // Slots are never removed, a new isolate at the address of a disposed one reuses its slot
+    std::vector<std::unique_ptr<Slot>> slots;
+    bool threadStarted = false;
+
+    // Default time limit of script executions in milliseconds, 0 disables the watchdog
+    uint32_t defaultTimeout = 5000;
+
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    void Thread()
+    {
+        while(true)
+        {
+            std::this_thread::sleep_for(PollInterval);
+
+            int64_t now = Now();
+            std::scoped_lock guard(lock);
+            for(auto& slot : slots)
+            {
+                int64_t deadline = slot->deadline.load(std::memory_order_relaxed);
+                if(deadline <= Unarmed || deadline > now) continue;
+                // Fails if the execution ended in the meantime
+                if(!slot->deadline.compare_exchange_strong(deadline, Terminating, std::memory_order_acq_rel)) continue;
+
+                // Thread safe, the execution is cancelled once the isolate returns to the embedder
+                slot->isolate->TerminateExecution();
+                slot->deadline.store(Terminated, std::memory_order_release);
+            }
+        }
+    }
+
+    Slot* GetSlot(v8::Isolate* isolate)
+    {
+        // Usually a thread only runs a single isolate
+        static thread_local Slot* lastSlot = nullptr;
+        if(lastSlot && lastSlot->isolate == isolate) return lastSlot;
+
+        std::scoped_lock guard(lock);
+        if(!threadStarted)
+        {
+            std::thread(&CWatchdog::Thread, this).detach();
+            threadStarted = true;
+        }
+
+        for(auto& slot : slots)
+        {
+            if(slot->isolate != isolate) continue;
+            lastSlot = slot.get();
+            return lastSlot;
+        }
+
+        auto& slot = slots.emplace_back(std::make_unique<Slot>());
+        slot->isolate = isolate;
+        lastSlot = slot.get();
+        return lastSlot;
+    }
+
+    // Returns true if the execution was terminated
+    static bool Disarm(Slot* slot)
+    {
+        int64_t deadline = slot->deadline.load(std::memory_order_acquire);
+        while(true)
+        {
+            // The thread is just terminating the execution, wait until it is done so it can be cancelled
+            if(deadline == Terminating)
+            {
+                std::this_thread::yield();
+                deadline = slot->deadline.load(std::memory_order_acquire);
+                continue;
+            }
+            if(slot->deadline.compare_exchange_weak(deadline, Unarmed, std::memory_order_acq_rel)) break;
+        }
+        return deadline == Terminated;
+    }
+
+    static uint32_t& GetDepth()
+    {
+        static thread_local uint32_t depth = 0;
+        return depth;
+    }
+
+public:
+    static CWatchdog& Instance()
+    {
+        // Never destroyed, the thread still uses it when the process exits
+        static CWatchdog* instance = new CWatchdog();
+        return *instance;
+    }
+
+    uint32_t GetDefaultTimeout() const
+    {
+        return defaultTimeout;
+    }
+    void SetDefaultTimeout(uint32_t timeout)
+    {
+        defaultTimeout = timeout;
+    }
+
+    // Watches the script execution until the scope is left.
+    // Only the outermost scope of a thread is watched, nested calls count towards its time limit
+    class Scope
+    {
+        v8::Isolate* isolate;
+        Slot* slot = nullptr;
+        bool terminated = false;
+
+    public:
+        Scope(v8::Isolate* _isolate, uint32_t timeout) : isolate(_isolate)
+        {
+            if(GetDepth()++ != 0 || timeout == 0) return;
+            slot = Instance().GetSlot(isolate);
+            slot->deadline.store(Now() + timeout, std::memory_order_relaxed);
+        }
+        ~Scope()
+        {
+            GetDepth()--;
+            Leave();
+        }
+
+        // Stops watching and recovers the isolate if the execution was terminated, returns true in that case
+        bool Leave()
+        {
+            if(!slot) return terminated;
+            terminated = Disarm(slot);
+            slot = nullptr;
+            if(terminated) isolate->CancelTerminateExecution();
+            return terminated;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
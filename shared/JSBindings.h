@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <memory>
+#include <v8.h>
 
 static std::string utilsBindings =
 #include "bindings/Utils.js.gen"
@@ -31,4 +33,42 @@ namespace JSBindings
 
         return code;
     }
+
+    // Compiles the bindings code as a function taking the specified parameters.
+    // The code cache of the first compilation is kept for the lifetime of the process,
+    // so the bindings only have to be parsed once instead of for every resource
+    inline v8::MaybeLocal<v8::Function> Compile(v8::Local<v8::Context> ctx, std::vector<v8::Local<v8::String>> params)
+    {
+        static std::vector<uint8_t> codeCache;
+
+        v8::Isolate* isolate = ctx->GetIsolate();
+        const std::string& code = GetBindingsCode();
+        v8::Local<v8::String> sourceCode = v8::String::NewFromUtf8(isolate, code.data(), v8::NewStringType::kNormal, (int)code.size()).ToLocalChecked();
+        v8::ScriptOrigin origin(isolate, v8::String::NewFromUtf8Literal(isolate, "<bindings>"));
+
+        v8::ScriptCompiler::CachedData* cachedData = nullptr;
+        if(!codeCache.empty()) cachedData = new v8::ScriptCompiler::CachedData(codeCache.data(), (int)codeCache.size(), v8::ScriptCompiler::CachedData::BufferNotOwned);
+        v8::ScriptCompiler::Source source{ sourceCode, origin, cachedData };
+        v8::ScriptCompiler::CompileOptions options = cachedData ? v8::ScriptCompiler::kConsumeCodeCache : v8::ScriptCompiler::kNoCompileOptions;
+
+#if V8_MAJOR_VERSION >= 10
+        v8::MaybeLocal<v8::Function> maybeFunc = v8::ScriptCompiler::CompileFunction(ctx, &source, params.size(), params.data(), 0, nullptr, options);
+#else
+        v8::MaybeLocal<v8::Function> maybeFunc = v8::ScriptCompiler::CompileFunctionInContext(ctx, &source, params.size(), params.data(), 0, nullptr, options);
+#endif
+
+        v8::Local<v8::Function> func;
+        if(!maybeFunc.ToLocal(&func)) return maybeFunc;
+
+        // Cache is created on the first compilation, or again if V8 rejected it (e.g. changed flags)
+        if(!cachedData || cachedData->rejected)
+        {
+            std::unique_ptr<v8::ScriptCompiler::CachedData> createdCache{ v8::ScriptCompiler::CreateCodeCacheForFunction(func) };
+            if(createdCache) codeCache.assign(createdCache->data, createdCache->data + createdCache->length);
+            else
+                codeCache.clear();
+        }
+
+        return func;
+    }
 }  // namespace JSBindings
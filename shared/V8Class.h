@@ -9,11 +9,13 @@
 class V8Class
 {
     using InitCallback = std::function<void(v8::Local<v8::FunctionTemplate>)>;
+    using InstanceCallback = void (*)(v8::Local<v8::ObjectTemplate>);
 
     V8Class* parent = nullptr;
     std::string name;
     v8::FunctionCallback constructor;
     InitCallback initCb;
+    InstanceCallback instanceCb = nullptr;
     std::unordered_map<v8::Isolate*, v8::Persistent<v8::FunctionTemplate, v8::CopyablePersistentTraits<v8::FunctionTemplate>>> tplMap;
 
 public:
@@ -49,6 +51,13 @@ public:
         return name;
     }
 
+    // Called with the instance template of this class and of all classes inheriting from it,
+    // for things V8 doesn't inherit from the parent template like interceptors. Has to be set before the class is loaded
+    void SetInstanceCallback(InstanceCallback cb)
+    {
+        instanceCb = cb;
+    }
+
     v8::Local<v8::Object> CreateInstance(v8::Local<v8::Context> ctx)
     {
         v8::Isolate* isolate = v8::Isolate::GetCurrent();
@@ -98,6 +107,13 @@ public:
             if(parentInternalFieldCount > _tpl->InstanceTemplate()->InternalFieldCount()) _tpl->InstanceTemplate()->SetInternalFieldCount(parentInternalFieldCount);
         }
 
+        for(V8Class* cls = this; cls; cls = cls->parent)
+        {
+            if(!cls->instanceCb) continue;
+            cls->instanceCb(_tpl->InstanceTemplate());
+            break;
+        }
+
         tplMap.insert({ isolate, { isolate, _tpl } });
     }
 
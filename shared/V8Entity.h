@@ -11,13 +11,65 @@ class V8Entity
     V8Class* _class;
     alt::Ref<alt::IBaseObject> handle;
     v8::Persistent<v8::Object, v8::CopyablePersistentTraits<v8::Object>> jsVal;
+    // Set once the script added own properties to the wrapper, it can't be recreated without losing them anymore
+    bool mutated = false;
 
-public:
-    V8Entity(v8::Local<v8::Context> ctx, V8Class* __class, v8::Local<v8::Object> obj, alt::Ref<alt::IBaseObject> _handle) : _class(__class), handle(_handle)
+    static inline bool weakWrappers = false;
+
+    static void OnCollected(const v8::WeakCallbackInfo<V8Entity>& info)
+    {
+        info.GetParameter()->jsVal.Reset();
+    }
+
+    // Called for every property set on the wrapper, without intercepting it.
+    // Marks the wrapper as mutated if the set creates an own property, which is the case unless
+    // the property is an accessor (like the native entity properties) somewhere on the prototype chain
+    static void PropertySetter(v8::Local<v8::Name> name, v8::Local<v8::Value>, const v8::PropertyCallbackInfo<v8::Value>& info)
+    {
+        v8::Local<v8::Object> obj = info.This();
+        V8Entity* ent = Get(obj);
+        if(!ent || ent->mutated) return;
+
+        v8::Local<v8::Context> ctx = info.GetIsolate()->GetCurrentContext();
+        for(v8::Local<v8::Value> proto = obj->GetPrototype(); proto->IsObject(); proto = proto.As<v8::Object>()->GetPrototype())
+        {
+            v8::Local<v8::Object> holder = proto.As<v8::Object>();
+            // Accessors are called instead, while data properties of the prototype are shadowed by a new own property
+            if(holder->HasRealNamedCallbackProperty(ctx, name).FromMaybe(false)) return;
+            if(holder->HasRealNamedProperty(ctx, name).FromMaybe(false)) break;
+        }
+        MarkMutated(obj);
+    }
+    static void PropertyDefiner(v8::Local<v8::Name>, const v8::PropertyDescriptor&, const v8::PropertyCallbackInfo<v8::Value>& info)
+    {
+        MarkMutated(info.This());
+    }
+    static void MarkMutated(v8::Local<v8::Object> obj)
+    {
+        V8Entity* ent = Get(obj);
+        if(!ent || ent->mutated) return;
+        ent->mutated = true;
+        if(!ent->jsVal.IsEmpty()) ent->jsVal.ClearWeak();
+    }
+
+    void SetJSVal(v8::Isolate* isolate, v8::Local<v8::Object> obj)
     {
-        v8::Isolate* isolate = v8::Isolate::GetCurrent();
         obj->SetInternalField(0, v8::External::New(isolate, this));
         jsVal.Reset(isolate, obj);
+        if(weakWrappers && !mutated) jsVal.SetWeak(this, &OnCollected, v8::WeakCallbackType::kParameter);
+    }
+
+public:
+    // Objects created by the script itself can be subclasses with their own state, so pass canRecreate = false for them
+    V8Entity(v8::Local<v8::Context> ctx, V8Class* __class, v8::Local<v8::Object> obj, alt::Ref<alt::IBaseObject> _handle, bool canRecreate = true)
+        : _class(__class), handle(_handle), mutated(!canRecreate)
+    {
+        SetJSVal(ctx->GetIsolate(), obj);
+    }
+
+    ~V8Entity()
+    {
+        jsVal.Reset();
     }
 
     V8Class* GetClass()
@@ -35,6 +87,34 @@ public:
         return jsVal.Get(isolate);
     }
 
+    // True if the wrapper was garbage collected and has to be recreated before it is used again
+    bool IsCollected() const
+    {
+        return jsVal.IsEmpty();
+    }
+    void Recreate(v8::Local<v8::Context> ctx)
+    {
+        SetJSVal(ctx->GetIsolate(), _class->CreateInstance(ctx));
+    }
+
+    // Wrappers of entities the script didn't add own properties to are only weakly held and recreated when needed again.
+    // A recreated wrapper is a different object, so it doesn't match keys of WeakMaps or WeakSets anymore
+    static bool AreWrappersWeak()
+    {
+        return weakWrappers;
+    }
+    static void SetWrappersWeak(bool state)
+    {
+        weakWrappers = state;
+    }
+
+    // Tracks whether the script adds own properties to the instances of the template. The interceptor has to see properties
+    // that exist on the prototype as well, so it can't be non-masking. It has no getter, so reading properties isn't intercepted
+    static void TrackMutations(v8::Local<v8::ObjectTemplate> tpl)
+    {
+        tpl->SetHandler(v8::NamedPropertyHandlerConfiguration(nullptr, &PropertySetter, nullptr, nullptr, nullptr, &PropertyDefiner, nullptr));
+    }
+
     static V8Entity* Get(v8::Local<v8::Value> val)
     {
         if(!val->IsObject()) return nullptr;
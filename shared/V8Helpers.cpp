@@ -2,11 +2,13 @@
 #include "cpp-sdk/ICore.h"
 #include "V8ResourceImpl.h"
 #include "V8Helpers.h"
+#include "CWatchdog.h"
 #ifdef ALT_CLIENT
     #include "CV8Resource.h"
 #endif
 
 #include <climits>
+#include <algorithm>
 #include <thread>
 #include <chrono>
 
@@ -152,6 +154,62 @@ V8Helpers::SourceLocation V8Helpers::SourceLocation::GetCurrent(v8::Isolate* iso
     return SourceLocation{ "[unknown]", 0, ctx };
 }
 
+V8Helpers::SourceLocation::CaptureMode V8Helpers::SourceLocation::captureMode = V8Helpers::SourceLocation::CaptureMode::LAZY;
+uint32_t V8Helpers::SourceLocation::sampleRate = 100;
+uint32_t V8Helpers::SourceLocation::sampleCounter = 0;
+
+V8Helpers::SourceLocation V8Helpers::SourceLocation::Capture(v8::Isolate* isolate)
+{
+    switch(captureMode)
+    {
+        case CaptureMode::ALWAYS: return GetCurrent(isolate);
+        case CaptureMode::SAMPLED:
+        {
+            if(++sampleCounter < sampleRate) return SourceLocation{};
+            sampleCounter = 0;
+            return GetCurrent(isolate);
+        }
+        default: return SourceLocation{};
+    }
+}
+
+V8Helpers::SourceLocation V8Helpers::SourceLocation::FromFunction(v8::Isolate* isolate, v8::Local<v8::Function> fn)
+{
+    auto ctx = isolate->GetEnteredOrMicrotaskContext();
+
+    // Bound functions don't have a script, use the function they are bound to
+    v8::Local<v8::Value> bound = fn->GetBoundFunction();
+    if(bound->IsFunction()) fn = bound.As<v8::Function>();
+
+    v8::Local<v8::Value> name = fn->GetScriptOrigin().ResourceName();
+    if(name.IsEmpty() || !name->IsString()) return SourceLocation{ "[unknown]", 0, ctx };
+
+    // Script line numbers are zero based, stack frame line numbers are not
+    int line = fn->GetScriptLineNumber();
+    return SourceLocation{ *v8::String::Utf8Value(isolate, name), line == v8::Function::kLineOffsetNotFound ? 0 : line + 1, ctx };
+}
+
+void V8Helpers::SourceLocation::SetCaptureMode(CaptureMode mode, uint32_t _sampleRate)
+{
+    captureMode = mode;
+    if(_sampleRate != 0) sampleRate = _sampleRate;
+    sampleCounter = 0;
+}
+
+bool V8Helpers::SourceLocation::ParseCaptureMode(const std::string& name, CaptureMode& mode)
+{
+    if(name == "off") mode = CaptureMode::OFF;
+    else if(name == "sampled")
+        mode = CaptureMode::SAMPLED;
+    else if(name == "lazy")
+        mode = CaptureMode::LAZY;
+    else if(name == "always")
+        mode = CaptureMode::ALWAYS;
+    else
+        return false;
+    return true;
+}
+
 V8Helpers::SourceLocation::SourceLocation(std::string&& _fileName, int _line, v8::Local<v8::Context> ctx) : fileName(_fileName), line(_line)
 {
     context.Reset(ctx->GetIsolate(), ctx);
@@ -276,7 +334,74 @@ v8::Local<v8::String> V8Helpers::Fire_WeaponKey(v8::Isolate* isolate)
     return aKey.Get(isolate);
 }
 
-std::vector<V8Helpers::EventCallback*> V8Helpers::EventHandler::GetCallbacks(V8ResourceImpl* impl, const alt::CEvent* e)
+V8Helpers::EventNames::Id V8Helpers::EventNames::Intern(const std::string& name)
+{
+    auto& _all = All();
+    auto it = _all.find(name);
+    if(it != _all.end()) return it->second;
+
+    Id id = (Id)_all.size();
+    _all.insert({ name, id });
+    return id;
+}
+
+V8Helpers::EventNames::Id V8Helpers::EventNames::Find(const std::string& name)
+{
+    auto& _all = All();
+    auto it = _all.find(name);
+
+    return (it != _all.end()) ? it->second : InvalidId;
+}
+
+void V8Helpers::EventCallbackMap::Add(EventNames::Id id, EventCallback* callback)
+{
+    if(id >= callbacks.size()) callbacks.resize(id + 1);
+    callbacks[id].push_back(callback);
+}
+
+bool V8Helpers::EventCallbackMap::Remove(v8::Isolate* isolate, const std::string& name, v8::Local<v8::Function> fn)
+{
+    EventNames::Id id = EventNames::Find(name);
+    if(id >= callbacks.size()) return false;
+
+    bool removed = false;
+    for(EventCallback* callback : callbacks[id])
+    {
+        if(callback->fn.Get(isolate)->StrictEquals(fn))
+        {
+            callback->removed = true;
+            removed = true;
+        }
+    }
+
+    return removed;
+}
+
+void V8Helpers::EventCallbackMap::RemoveMarked()
+{
+    for(Callbacks& list : callbacks) RemoveMarked(list);
+}
+
+void V8Helpers::EventCallbackMap::Clear()
+{
+    for(Callbacks& list : callbacks)
+    {
+        for(EventCallback* callback : list) delete callback;
+    }
+    callbacks.clear();
+}
+
+void V8Helpers::EventCallbackMap::RemoveMarked(Callbacks& list)
+{
+    auto end = std::remove_if(list.begin(), list.end(), [](EventCallback* callback) {
+        if(!callback->removed) return false;
+        delete callback;
+        return true;
+    });
+    list.erase(end, list.end());
+}
+
+const std::vector<V8Helpers::EventCallback*>& V8Helpers::EventHandler::GetCallbacks(V8ResourceImpl* impl, const alt::CEvent* e)
 {
     return callbacksGetter(impl, e);
 }
@@ -311,7 +436,8 @@ void V8Helpers::EventHandler::Register(alt::CEvent::Type type, EventHandler* han
 
 V8Helpers::EventHandler::CallbacksGetter V8Helpers::LocalEventHandler::GetCallbacksGetter(const std::string& name)
 {
-    return [name](V8ResourceImpl* resource, const alt::CEvent*) -> std::vector<EventCallback*> { return resource->GetLocalHandlers(name); };
+    EventNames::Id id = EventNames::Intern(name);
+    return [id](V8ResourceImpl* resource, const alt::CEvent*) -> const std::vector<EventCallback*>& { return resource->GetLocalHandlers(id); };
 }
 
 V8Helpers::EventHandler::EventHandler(alt::CEvent::Type type, CallbacksGetter&& _handlersGetter, ArgsGetter&& _argsGetter)
@@ -376,24 +502,21 @@ std::string V8Helpers::GetJSValueTypeName(v8::Local<v8::Value> val)
         return "unknown";
 }
 
-v8::MaybeLocal<v8::Value> V8Helpers::CallFunctionWithTimeout(v8::Local<v8::Function> fn, v8::Local<v8::Context> ctx, std::vector<v8::Local<v8::Value>>& args, uint32_t timeout)
+v8::MaybeLocal<v8::Value> V8Helpers::CallFunctionWithTimeout(v8::Local<v8::Function> fn, v8::Local<v8::Context> ctx, std::vector<v8::Local<v8::Value>>& args, int64_t timeout)
 {
     v8::Isolate* isolate = ctx->GetIsolate();
-    /*std::shared_ptr<bool> hasTimedOut{ new bool(false) };
-    std::shared_ptr<bool> hasFinished{ new bool(false) };
-    std::thread([=]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
-        if(*hasFinished || isolate->IsExecutionTerminating()) return;
-        *hasTimedOut = true;
-        isolate->TerminateExecution();
-    }).detach();*/
+    V8ResourceImpl* resource = V8ResourceImpl::Get(ctx);
+    if(timeout < 0) timeout = resource ? resource->GetExecutionTimeout() : CWatchdog::Instance().GetDefaultTimeout();
 
+    CWatchdog::Scope watchdogScope(isolate, (uint32_t)timeout);
     v8::MaybeLocal<v8::Value> result = fn->Call(ctx, v8::Undefined(isolate), args.size(), args.data());
-    /**hasFinished = true;
-    if(*hasTimedOut)
+
+    // Recover the isolate right away, so the caller can handle the failed call like any other exception
+    if(watchdogScope.Leave())
     {
-        Log::Error << "[V8] Script execution timed out" << Log::Endl;
+        Log::Error << "[V8] Script execution in " << (resource ? resource->GetResource()->GetName().CStr() : "unknown resource") << " exceeded " << timeout
+                   << "ms and was terminated" << Log::Endl;
         return v8::MaybeLocal<v8::Value>();
-    }*/
+    }
     return result;
 }
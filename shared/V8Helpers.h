@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <functional>
 
 #include <v8.h>
@@ -48,6 +49,21 @@ namespace V8Helpers
     class SourceLocation
     {
     public:
+        // Controls how locations of subscriptions and timers are captured, walking the stack
+        // on every alt.on / setTimeout call is expensive for resources that create a lot of them
+        enum class CaptureMode : uint8_t
+        {
+            // Never capture, slow callback warnings are printed without a location
+            OFF,
+            // Capture the stack of every n-th call, the other ones are resolved lazily
+            SAMPLED,
+            // Don't capture, resolve the location from the function once it's needed
+            LAZY,
+            // Capture the stack on every call
+            ALWAYS
+        };
+
+        SourceLocation() = default;
         SourceLocation(std::string&& fileName, int line, v8::Local<v8::Context> ctx);
 
         const std::string& GetFileName() const
@@ -59,11 +75,31 @@ namespace V8Helpers
             return line;
         }
 
+        bool IsEmpty() const
+        {
+            return fileName.empty();
+        }
+
         std::string ToString();
 
         static SourceLocation GetCurrent(v8::Isolate* isolate);
+        // Same as GetCurrent, but respects the capture mode and returns an empty location if the stack was not captured
+        static SourceLocation Capture(v8::Isolate* isolate);
+        // Location where the function was defined, used to resolve locations that were not captured
+        static SourceLocation FromFunction(v8::Isolate* isolate, v8::Local<v8::Function> fn);
+
+        static CaptureMode GetCaptureMode()
+        {
+            return captureMode;
+        }
+        static void SetCaptureMode(CaptureMode mode, uint32_t sampleRate = 0);
+        static bool ParseCaptureMode(const std::string& name, CaptureMode& mode);
 
     private:
+        static CaptureMode captureMode;
+        static uint32_t sampleRate;
+        static uint32_t sampleCounter;
+
         CPersistent<v8::Context> context;
         std::string fileName;
         int line = 0;
@@ -104,10 +140,80 @@ namespace V8Helpers
         EventCallback(v8::Isolate* isolate, v8::Local<v8::Function> _fn, SourceLocation&& location, bool once = false) : fn(isolate, _fn), location(std::move(location)), once(once) {}
     };
 
+    // Maps event names to dense ids, names are only interned when a handler is subscribed,
+    // so dispatching an event never grows the table
+    class EventNames
+    {
+    public:
+        using Id = uint32_t;
+        static constexpr Id InvalidId = std::numeric_limits<Id>::max();
+
+        static Id Intern(const std::string& name);
+        static Id Find(const std::string& name);
+
+    private:
+        static std::unordered_map<std::string, Id>& All()
+        {
+            static std::unordered_map<std::string, Id> _all;
+            return _all;
+        }
+    };
+
+    // Owns event callbacks, stored in one contiguous vector per interned event name
+    class EventCallbackMap
+    {
+    public:
+        using Callbacks = std::vector<EventCallback*>;
+
+        EventCallbackMap() = default;
+        EventCallbackMap(EventCallbackMap&&) = default;
+        EventCallbackMap& operator=(EventCallbackMap&&) = default;
+        EventCallbackMap(const EventCallbackMap&) = delete;
+        EventCallbackMap& operator=(const EventCallbackMap&) = delete;
+
+        ~EventCallbackMap()
+        {
+            Clear();
+        }
+
+        void Add(EventNames::Id id, EventCallback* callback);
+        void Add(const std::string& name, EventCallback* callback)
+        {
+            Add(EventNames::Intern(name), callback);
+        }
+
+        const Callbacks& Get(EventNames::Id id) const
+        {
+            if(id >= callbacks.size()) return Empty();
+            return callbacks[id];
+        }
+        const Callbacks& Get(const std::string& name) const
+        {
+            return Get(EventNames::Find(name));
+        }
+
+        // Marks all callbacks with the specified function as removed, they are deleted on the next RemoveMarked call
+        bool Remove(v8::Isolate* isolate, const std::string& name, v8::Local<v8::Function> fn);
+
+        void RemoveMarked();
+        void Clear();
+
+        static void RemoveMarked(Callbacks& list);
+        static const Callbacks& Empty()
+        {
+            static Callbacks empty;
+            return empty;
+        }
+
+    private:
+        // Deque so references handed out by Get stay valid when a new event name is added while dispatching
+        std::deque<Callbacks> callbacks;
+    };
+
     class EventHandler
     {
     public:
-        using CallbacksGetter = std::function<std::vector<EventCallback*>(V8ResourceImpl* resource, const alt::CEvent*)>;
+        using CallbacksGetter = std::function<const std::vector<EventCallback*>&(V8ResourceImpl* resource, const alt::CEvent*)>;
         using ArgsGetter = std::function<void(V8ResourceImpl* resource, const alt::CEvent*, std::vector<v8::Local<v8::Value>>& args)>;
 
         EventHandler(alt::CEvent::Type type, CallbacksGetter&& _handlersGetter, ArgsGetter&& _argsGetter);
@@ -115,7 +221,7 @@ namespace V8Helpers
         // Temp issue fix for https://stackoverflow.com/questions/9459980/c-global-variable-not-initialized-when-linked-through-static-libraries-but-ok
         void Reference();
 
-        std::vector<V8Helpers::EventCallback*> GetCallbacks(V8ResourceImpl* impl, const alt::CEvent* e);
+        const std::vector<V8Helpers::EventCallback*>& GetCallbacks(V8ResourceImpl* impl, const alt::CEvent* e);
         std::vector<v8::Local<v8::Value>> GetArgs(V8ResourceImpl* impl, const alt::CEvent* e);
 
         static EventHandler* Get(const alt::CEvent* e);
@@ -185,6 +291,8 @@ namespace V8Helpers
         return *strValue;
     }
 
-    v8::MaybeLocal<v8::Value> CallFunctionWithTimeout(v8::Local<v8::Function> fn, v8::Local<v8::Context> ctx, std::vector<v8::Local<v8::Value>>& args, uint32_t timeout = 5000);
+    // Calls the function and terminates it if it runs longer than the timeout in milliseconds.
+    // A negative timeout uses the execution timeout of the resource the context belongs to, 0 disables it
+    v8::MaybeLocal<v8::Value> CallFunctionWithTimeout(v8::Local<v8::Function> fn, v8::Local<v8::Context> ctx, std::vector<v8::Local<v8::Value>>& args, int64_t timeout = -1);
 
 }  // namespace V8Helpers
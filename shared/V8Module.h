@@ -67,10 +67,19 @@ public:
         creator(context, exports);
     }
 
+    // Exports are only created once per context, every later call returns the same object
     v8::Local<v8::Object> GetExports(v8::Isolate* isolate, v8::Local<v8::Context> context)
     {
+        std::string keyName = "alt:module:" + moduleName;
+        v8::Local<v8::Private> key = v8::Private::ForApi(isolate, v8::String::NewFromUtf8(isolate, keyName.c_str(), v8::NewStringType::kInternalized).ToLocalChecked());
+        v8::Local<v8::Object> global = context->Global();
+
+        v8::Local<v8::Value> cached;
+        if(global->GetPrivate(context, key).ToLocal(&cached) && cached->IsObject()) return cached.As<v8::Object>();
+
         v8::Local<v8::Object> _exports = v8::Object::New(isolate);
         Register(isolate, context, _exports);
+        global->SetPrivate(context, key, _exports);
         return _exports;
     }
 };
@@ -2,6 +2,8 @@
 #include "cpp-sdk/objects/IPlayer.h"
 #include "cpp-sdk/objects/IVehicle.h"
 #include "cpp-sdk/events/CPlayerBeforeConnectEvent.h"
+#include "cpp-sdk/events/CClientScriptEvent.h"
+#include "cpp-sdk/events/CServerScriptEvent.h"
 
 #include "V8ResourceImpl.h"
 
@@ -25,6 +27,9 @@ V8ResourceImpl::~V8ResourceImpl()
     }
 
     entities.clear();
+
+    for(auto handler : localGenericHandlers) delete handler;
+    for(auto handler : remoteGenericHandlers) delete handler;
 }
 
 extern V8Class v8Vector3, v8Vector2, v8RGBA, v8BaseObject;
@@ -46,75 +51,160 @@ bool V8ResourceImpl::Stop()
     }
     timers.clear();
     oldTimers.clear();
+    everyTickTimers.clear();
+    timerWheel.Clear(GetTime());
     resourceObjects.clear();
+    resourceExports.clear();
     nextTickCallbacks.clear();
+    asyncCallbacks->Close();
+    asyncPromises.clear();
 
     return true;
 }
 
 void V8ResourceImpl::OnTick()
 {
-    for(auto& nextTickCb : nextTickCallbacks) nextTickCb();
+    for(auto& nextTickCb : nextTickCallbacks)
+    {
+        int64_t start = GetMicroTime();
+        nextTickCb();
+        stats.nextTick.Add(GetMicroTime() - start);
+    }
     nextTickCallbacks.clear();
 
-    for(auto& id : oldTimers) timers.erase(id);
+    for(auto& asyncCb : asyncCallbacks->Take())
+    {
+        int64_t start = GetMicroTime();
+        asyncCb();
+        stats.nextTick.Add(GetMicroTime() - start);
+    }
+
+    for(auto& id : oldTimers)
+    {
+        auto it = timers.find(id);
+        if(it == timers.end()) continue;
+
+        if(it->second->IsEveryTick()) everyTickTimers.erase(std::find(everyTickTimers.begin(), everyTickTimers.end(), id));
+        delete it->second;
+        timers.erase(it);
+    }
 
     oldTimers.clear();
 
-    for(auto& p : timers)
+    // Only the timers that are due are returned by the wheel,
+    // stale entries of removed timers are skipped on expiry
+    std::vector<uint32_t> expired;
+    expired.swap(expiredTimers);
+    timerWheel.Advance(GetTime(), expired);
+    for(uint32_t id : expired)
     {
-        int64_t time = GetTime();
-
-        if(!p.second->Update(time)) RemoveTimer(p.first);
+        auto it = timers.find(id);
+        if(it == timers.end() || it->second->IsRemoved()) continue;
 
-        if(GetTime() - time > 10)
-        {
-            auto& location = p.second->GetLocation();
+        V8Timer* timer = it->second;
+        RunTimer(id, timer);
+        if(!timer->IsRemoved()) timerWheel.Schedule(id, timer->GetNextRun());
+    }
+    // Keep the buffer around, so we don't allocate on every tick
+    expired.clear();
+    expiredTimers.swap(expired);
 
-            if(location.GetLineNumber() != 0)
-            {
-                Log::Warning << "Timer at " << resource->GetName() << ":" << location.GetFileName() << ":" << location.GetLineNumber() << " was too long " << GetTime() - time << "ms"
-                             << Log::Endl;
-            }
-            else
-            {
-                Log::Warning << "Timer at " << resource->GetName() << ":" << location.GetFileName() << " was too long " << GetTime() - time << "ms" << Log::Endl;
-            }
-        }
+    // Timers created while iterating are appended to the end and first run on the next tick
+    for(size_t i = 0, size = everyTickTimers.size(); i < size; i++)
+    {
+        V8Timer* timer = timers.at(everyTickTimers[i]);
+        if(!timer->IsRemoved()) RunTimer(everyTickTimers[i], timer);
     }
 
-    for(auto it = localHandlers.begin(); it != localHandlers.end();)
+    if(hasRemovedHandlers && eventDispatchDepth == 0)
     {
-        if(it->second.removed) it = localHandlers.erase(it);
-        else
-            ++it;
+        localHandlers.RemoveMarked();
+        remoteHandlers.RemoveMarked();
+        V8Helpers::EventCallbackMap::RemoveMarked(localGenericHandlers);
+        V8Helpers::EventCallbackMap::RemoveMarked(remoteGenericHandlers);
+        hasRemovedHandlers = false;
     }
+}
+
+void V8ResourceImpl::RunTimer(uint32_t id, V8Timer* timer)
+{
+    int64_t time = GetTime();
+    int64_t start = GetMicroTime();
+    if(!timer->IsEveryTick()) stats.timerLag.Record(time > timer->GetNextRun() ? (time - timer->GetNextRun()) * 1000 : 0);
 
-    for(auto it = remoteHandlers.begin(); it != remoteHandlers.end();)
     {
-        if(it->second.removed) it = remoteHandlers.erase(it);
-        else
-            ++it;
+        CTracer::Scope traceScope("timer", timer->IsEveryTick() ? "EveryTick" : "Timer", resource->GetName().CStr());
+        if(!timer->Update(time)) RemoveTimer(id);
     }
 
-    for(auto it = localGenericHandlers.begin(); it != localGenericHandlers.end();)
+    int64_t elapsed = GetMicroTime() - start;
+    if(timer->IsEveryTick()) stats.everyTick.Add(elapsed);
+    else
+        stats.timers.Add(elapsed);
+
+    int64_t duration = elapsed / 1000;
+    if(duration > 10) WarnSlowCallback("Timer", timer->GetLocation(), timer->GetCallback(), duration);
+}
+
+void V8ResourceImpl::WarnSlowCallback(const char* type, V8Helpers::SourceLocation& location, v8::Local<v8::Function> fn, int64_t duration)
+{
+    // Location was not captured when the callback was registered, resolve it once and keep it for the next warnings
+    if(location.IsEmpty() && V8Helpers::SourceLocation::GetCaptureMode() != V8Helpers::SourceLocation::CaptureMode::OFF)
+        location = V8Helpers::SourceLocation::FromFunction(isolate, fn);
+
+    if(location.IsEmpty()) Log::Warning << type << " in " << resource->GetName() << " was too long " << duration << "ms" << Log::Endl;
+    else if(location.GetLineNumber() != 0)
+        Log::Warning << type << " at " << resource->GetName() << ":" << location.GetFileName() << ":" << location.GetLineNumber() << " was too long " << duration << "ms" << Log::Endl;
+    else
+        Log::Warning << type << " at " << resource->GetName() << ":" << location.GetFileName() << " was too long " << duration << "ms" << Log::Endl;
+}
+
+std::string V8ResourceImpl::GetEventTraceName(const alt::CEvent* ev)
+{
+    switch(ev->GetType())
     {
-        if(it->removed) it = localGenericHandlers.erase(it);
-        else
-            ++it;
+        case alt::CEvent::Type::CLIENT_SCRIPT_EVENT: return static_cast<const alt::CClientScriptEvent*>(ev)->GetName().ToString();
+        case alt::CEvent::Type::SERVER_SCRIPT_EVENT: return static_cast<const alt::CServerScriptEvent*>(ev)->GetName().ToString();
+        default: return "Event " + std::to_string((int)ev->GetType());
     }
+}
 
-    for(auto it = remoteGenericHandlers.begin(); it != remoteGenericHandlers.end();)
+void V8ResourceImpl::LogStats()
+{
+    auto logEntry = [](const char* name, const Stats::Entry& entry) {
+        Log::Info << "  " << name << ": " << entry.calls << " calls, " << entry.totalTime / 1000 << "ms total, " << entry.maxTime / 1000.0 << "ms max" << Log::Endl;
+    };
+
+    std::ostringstream heap;
+    if(stats.heapSize >= 0) heap << ", " << stats.heapSize / 1024 << "KB heap";
+    else
+        heap << ", heap not measured";
+    Log::Info << resource->GetName() << ": started in " << stats.startTime / 1000 << "ms" << heap.str() << Log::Endl;
+
+    size_t collectedEntities = 0;
+    for(auto& [handle, ent] : entities)
     {
-        if(it->removed) it = remoteGenericHandlers.erase(it);
-        else
-            ++it;
+        if(ent->IsCollected()) collectedEntities++;
     }
+    Log::Info << "  Entities: " << entities.size() << " wrapped, " << collectedEntities << " collected" << Log::Endl;
+
+    logEntry("Event handlers", stats.eventHandlers);
+    logEntry("Timers", stats.timers);
+    logEntry("EveryTick", stats.everyTick);
+    logEntry("NextTick", stats.nextTick);
+    logEntry("Exports", stats.exports);
+    LogHistogram("Timer lag", stats.timerLag);
+}
+
+void V8ResourceImpl::LogHistogram(const char* name, const CHistogram& histogram)
+{
+    Log::Info << "  " << name << ": " << histogram.GetCount() << " samples, p50 " << histogram.GetPercentile(50) / 1000.0 << "ms, p90 " << histogram.GetPercentile(90) / 1000.0 << "ms, p99 "
+              << histogram.GetPercentile(99) / 1000.0 << "ms, max " << histogram.GetMax() / 1000.0 << "ms" << Log::Endl;
 }
 
 void V8ResourceImpl::BindEntity(v8::Local<v8::Object> val, alt::Ref<alt::IBaseObject> handle)
 {
-    V8Entity* ent = new V8Entity(GetContext(), V8Entity::GetClass(handle), val, handle);
+    V8Entity* ent = new V8Entity(GetContext(), V8Entity::GetClass(handle), val, handle, false);
     entities.insert({ handle.Get(), ent });
 }
 
@@ -127,9 +217,16 @@ v8::Local<v8::Value> V8ResourceImpl::GetBaseObjectOrNull(alt::IBaseObject* handl
 
 v8::Local<v8::Value> V8ResourceImpl::CreateVector3(alt::Vector3f vec)
 {
-    std::vector<v8::Local<v8::Value>> args{ V8Helpers::JSValue(vec[0]), V8Helpers::JSValue(vec[1]), V8Helpers::JSValue(vec[2]) };
+    // Vectors are created for every position getter, so fill the instance directly instead of
+    // calling the constructor, the properties are defined in the same order to keep the same map
+    v8::Local<v8::Context> ctx = GetContext();
+    v8::Local<v8::Object> obj = v8Vector3.CreateInstance(ctx);
+
+    V8Helpers::DefineOwnProperty(isolate, ctx, obj, V8Helpers::Vector3_XKey(isolate), V8Helpers::JSValue(vec[0]), v8::PropertyAttribute::ReadOnly);
+    V8Helpers::DefineOwnProperty(isolate, ctx, obj, V8Helpers::Vector3_YKey(isolate), V8Helpers::JSValue(vec[1]), v8::PropertyAttribute::ReadOnly);
+    V8Helpers::DefineOwnProperty(isolate, ctx, obj, V8Helpers::Vector3_ZKey(isolate), V8Helpers::JSValue(vec[2]), v8::PropertyAttribute::ReadOnly);
 
-    return v8Vector3.CreateInstance(isolate, GetContext(), args);
+    return obj;
 }
 
 v8::Local<v8::Value> V8ResourceImpl::CreateVector2(alt::Vector2f vec)
@@ -146,6 +243,38 @@ v8::Local<v8::Value> V8ResourceImpl::CreateRGBA(alt::RGBA rgba)
     return V8Helpers::New(isolate, GetContext(), rgbaClass.Get(isolate), args);
 }
 
+V8ResourceImpl::ObjectShape* V8ResourceImpl::GetObjectShape(alt::MValueDictConst& dict)
+{
+    objectShapeId.clear();
+    size_t keyCount = 0;
+    for(auto it = dict->Begin(); it; it = dict->Next())
+    {
+        const std::string& key = it->GetKey();
+        // Index keys are stored as elements, not as properties of the hidden class
+        if(key.empty() || (key[0] >= '0' && key[0] <= '9') || ++keyCount > MaxObjectShapeKeys) return nullptr;
+        objectShapeId.append(key);
+        objectShapeId.push_back('\0');
+    }
+
+    auto it = objectShapes.find(objectShapeId);
+    if(it != objectShapes.end()) return &it->second;
+    if(objectShapes.size() >= MaxObjectShapes) return nullptr;
+
+    ObjectShape shape;
+    v8::Local<v8::ObjectTemplate> tpl = v8::ObjectTemplate::New(isolate);
+    for(size_t start = 0, end; start < objectShapeId.size(); start = end + 1)
+    {
+        end = objectShapeId.find('\0', start);
+        v8::Local<v8::String> key = v8::String::NewFromUtf8(isolate, objectShapeId.data() + start, v8::NewStringType::kInternalized, (int)(end - start)).ToLocalChecked();
+        tpl->Set(key, v8::Undefined(isolate));
+        shape.keys.emplace_back(isolate, key);
+    }
+    shape.tpl.Reset(isolate, tpl);
+
+    // Nodes of the map are never moved, so the shape stays valid while more shapes are added
+    return &objectShapes.emplace(objectShapeId, std::move(shape)).first->second;
+}
+
 bool V8ResourceImpl::IsVector3(v8::Local<v8::Value> val)
 {
     bool result = false;
@@ -206,8 +335,7 @@ void V8ResourceImpl::OnRemoveBaseObject(alt::Ref<alt::IBaseObject> handle)
 
     entities.erase(handle.Get());
 
-    // TODO: ent->SetWeak();
-    ent->GetJSVal(isolate)->SetInternalField(0, v8::External::New(isolate, nullptr));
+    if(!ent->IsCollected()) ent->GetJSVal(isolate)->SetInternalField(0, v8::External::New(isolate, nullptr));
     delete ent;
 }
 
@@ -266,36 +394,6 @@ v8::Local<v8::Array> V8ResourceImpl::GetAllVehicles()
     return vehicles.Get(isolate);
 }
 
-std::vector<V8Helpers::EventCallback*> V8ResourceImpl::GetLocalHandlers(const std::string& name)
-{
-    std::vector<V8Helpers::EventCallback*> handlers;
-    auto range = localHandlers.equal_range(name);
-
-    for(auto it = range.first; it != range.second; ++it) handlers.push_back(&it->second);
-
-    return handlers;
-}
-
-std::vector<V8Helpers::EventCallback*> V8ResourceImpl::GetRemoteHandlers(const std::string& name)
-{
-    std::vector<V8Helpers::EventCallback*> handlers;
-    auto range = remoteHandlers.equal_range(name);
-
-    for(auto it = range.first; it != range.second; ++it) handlers.push_back(&it->second);
-
-    return handlers;
-}
-
-std::vector<V8Helpers::EventCallback*> V8ResourceImpl::GetGenericHandlers(bool local)
-{
-    std::vector<V8Helpers::EventCallback*> handlers;
-    if(local)
-        for(auto& it : localGenericHandlers) handlers.push_back(&it);
-    else
-        for(auto& it : remoteGenericHandlers) handlers.push_back(&it);
-    return handlers;
-}
-
 extern V8Class v8Resource;
 v8::Local<v8::Object> V8ResourceImpl::GetOrCreateResourceObject(alt::IResource* resource)
 {
@@ -308,18 +406,46 @@ v8::Local<v8::Object> V8ResourceImpl::GetOrCreateResourceObject(alt::IResource*
     return obj;
 }
 
+v8::Local<v8::Value> V8ResourceImpl::GetResourceExports(alt::IResource* resource)
+{
+    alt::MValueDict dict = resource->GetExports();
+    auto it = resourceExports.find(resource);
+    if(it != resourceExports.end() && it->second.dict.Get() == dict.Get()) return it->second.value.Get(isolate);
+
+    v8::Local<v8::Value> value = V8Helpers::MValueToV8(dict);
+    resourceExports[resource] = ResourceExports{ dict, V8Helpers::CPersistent<v8::Value>(isolate, value) };
+    return value;
+}
+
 void V8ResourceImpl::InvokeEventHandlers(const alt::CEvent* ev, const std::vector<V8Helpers::EventCallback*>& handlers, std::vector<v8::Local<v8::Value>>& args, bool waitForPromiseResolve)
 {
-    for(auto handler : handlers)
+    eventDispatchDepth++;
+
+    // Handlers subscribed while dispatching are appended to the same vector, so iterate by index
+    for(size_t i = 0, size = handlers.size(); i < size; i++)
     {
+        V8Helpers::EventCallback* handler = handlers[i];
         if(handler->removed) continue;
-        int64_t time = GetTime();
+        int64_t start = GetMicroTime();
+        CTracer::Scope traceScope("event", "Event handler", resource->GetName().CStr());
+        v8::Local<v8::Promise> pendingPromise;
 
         V8Helpers::TryCatch([&] {
             v8::MaybeLocal<v8::Value> retn = V8Helpers::CallFunctionWithTimeout(handler->fn.Get(isolate), GetContext(), args);
             if(retn.IsEmpty()) return false;
 
             v8::Local<v8::Value> returnValue = retn.ToLocalChecked();
+            if(returnValue->IsPromise())
+            {
+                // Async handlers that didn't await anything have already settled, so they can still cancel the event.
+                // Core events can't be held until a pending promise settles, the handler only decides how long they are waited for
+                v8::Local<v8::Promise> promise = returnValue.As<v8::Promise>();
+                v8::Promise::PromiseState state = promise->State();
+                if(state == v8::Promise::PromiseState::kFulfilled) returnValue = promise->Result();
+                else if(state == v8::Promise::PromiseState::kPending && waitForPromiseResolve)
+                    pendingPromise = promise;
+            }
+
             if(ev && returnValue->IsFalse()) ev->Cancel();
             else if(ev && ev->GetType() == alt::CEvent::Type::PLAYER_BEFORE_CONNECT && returnValue->IsString())
                 static_cast<alt::CPlayerBeforeConnectEvent*>(const_cast<alt::CEvent*>(ev))->Cancel(*v8::String::Utf8Value(isolate, returnValue));
@@ -327,53 +453,65 @@ void V8ResourceImpl::InvokeEventHandlers(const alt::CEvent* ev, const std::vecto
             // else if(ev && returnValue->IsString())
             //    ev->Cancel(*v8::String::Utf8Value(isolate, returnValue));
 
-            // Wait until the returned promise has been resolved, by continously forcing the event loop to run,
-            // until the promise is resolved.
-            if(waitForPromiseResolve && returnValue->IsPromise())
-            {
-                v8::Local<v8::Promise> promise = returnValue.As<v8::Promise>();
-                while(true)
-                {
-                    v8::Promise::PromiseState state = promise->State();
-                    if(state == v8::Promise::PromiseState::kPending)
-                    {
-#ifdef ALT_CLIENT_API
-                        CV8ScriptRuntime::Instance().OnTick();
-#endif
-#ifdef ALT_SERVER_API
-                        CNodeScriptRuntime::Instance().OnTick();
-#endif
-                        // Run event loop
-                        OnTick();
-                    }
-                    else if(state == v8::Promise::PromiseState::kFulfilled)
-                    {
-                        v8::Local<v8::Value> value = promise->Result();
-                        if(value->IsFalse()) ev->Cancel();
-                        break;
-                    }
-                    else if(state == v8::Promise::PromiseState::kRejected)
-                    {
-                        // todo: we should probably do something with the rejection here
-                        break;
-                    }
-                }
-            }
-
             return true;
         });
 
-        if(GetTime() - time > 5 && !waitForPromiseResolve)
+        // Waiting for the promise runs whole ticks, which are already accounted for
+        int64_t elapsed = GetMicroTime() - start;
+        stats.eventHandlers.Add(elapsed);
+
+        int64_t duration = elapsed / 1000;
+        if(duration > 5) WarnSlowCallback("Event handler", handler->location, handler->fn.Get(isolate), duration);
+
+        // Handlers can depend on the work of the previous ones, so the next one only runs once the promise settled
+        if(!pendingPromise.IsEmpty() && AwaitPromise(pendingPromise, handler) && pendingPromise->State() == v8::Promise::PromiseState::kFulfilled)
+        {
+            if(ev && pendingPromise->Result()->IsFalse()) ev->Cancel();
+        }
+
+        if(handler->once)
+        {
+            handler->removed = true;
+            hasRemovedHandlers = true;
+        }
+    }
+
+    eventDispatchDepth--;
+}
+
+// The core expects the result of resource start and stop once the event returns and can't be resumed later,
+// so the only way to wait for a promise is to keep ticking until it settled
+bool V8ResourceImpl::AwaitPromise(v8::Local<v8::Promise> promise, V8Helpers::EventCallback* handler)
+{
+    CTracer::Scope traceScope("event", "Await event handler", resource->GetName().CStr());
+    int64_t deadline = asyncEventTimeout == 0 ? 0 : GetTime() + asyncEventTimeout;
+
+    while(promise->State() == v8::Promise::PromiseState::kPending)
+    {
+        if(deadline != 0 && GetTime() >= deadline)
         {
-            if(handler->location.GetLineNumber() != 0)
-                Log::Warning << "Event handler at " << resource->GetName() << ":" << handler->location.GetFileName() << ":" << handler->location.GetLineNumber() << " was too long "
-                             << (GetTime() - time) << "ms" << Log::Endl;
+            V8Helpers::SourceLocation& location = handler->location;
+            if(location.IsEmpty() && V8Helpers::SourceLocation::GetCaptureMode() != V8Helpers::SourceLocation::CaptureMode::OFF)
+                location = V8Helpers::SourceLocation::FromFunction(isolate, handler->fn.Get(isolate));
+
+            if(location.IsEmpty()) Log::Warning << resource->GetName() << ": Stopped waiting for an event handler promise after " << asyncEventTimeout << "ms" << Log::Endl;
             else
-                Log::Warning << "Event handler at " << resource->GetName() << ":" << handler->location.GetFileName() << " was too long " << (GetTime() - time) << "ms" << Log::Endl;
+                Log::Warning << resource->GetName() << ": Stopped waiting for the promise of the event handler at " << location.GetFileName() << ":" << location.GetLineNumber()
+                             << " after " << asyncEventTimeout << "ms" << Log::Endl;
+            return false;
         }
 
-        if(handler->once) handler->removed = true;
+        // The promise can only settle by running the event loop. Rejections are reported by the
+        // unhandled rejection tracking like for any other promise
+#ifdef ALT_CLIENT_API
+        CV8ScriptRuntime::Instance().OnTick();
+#endif
+#ifdef ALT_SERVER_API
+        CNodeScriptRuntime::Instance().OnTick();
+#endif
+        OnTick();
     }
+    return true;
 }
 
 alt::MValue V8ResourceImpl::FunctionImpl::Call(alt::MValueArgs args) const
@@ -397,6 +535,8 @@ alt::MValue V8ResourceImpl::FunctionImpl::Call(alt::MValueArgs args) const
     V8Helpers::MValueArgsToV8(args, v8Args);
 
     alt::MValue res;
+    int64_t start = GetMicroTime();
+    CTracer::Scope traceScope("export", "Exported function", resource->GetResource()->GetName().CStr());
     V8Helpers::TryCatch([&] {
         v8::MaybeLocal<v8::Value> _res = V8Helpers::CallFunctionWithTimeout(function.Get(isolate), resource->GetContext(), v8Args);
 
@@ -406,6 +546,8 @@ alt::MValue V8ResourceImpl::FunctionImpl::Call(alt::MValueArgs args) const
         return true;
     });
 
+    resource->stats.exports.Add(GetMicroTime() - start);
+
     if(res.IsEmpty()) res = alt::ICore::Instance().CreateMValueNone();
 
     return res;
@@ -2,6 +2,9 @@
 
 #include <chrono>
 #include <filesystem>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 #include "cpp-sdk/types/MValue.h"
 #include "cpp-sdk/IResource.h"
@@ -9,6 +12,10 @@
 
 #include "V8Entity.h"
 #include "V8Timer.h"
+#include "CTimerWheel.h"
+#include "CTracer.h"
+#include "CHistogram.h"
+#include "CWatchdog.h"
 
 class V8ResourceImpl : public alt::IResource::Impl
 {
@@ -25,6 +32,38 @@ public:
         v8::UniquePersistent<v8::Function> function;
     };
 
+    // Time the scripts of the resource spent running, used to find the resource causing tick spikes
+    struct Stats
+    {
+        struct Entry
+        {
+            uint64_t calls = 0;
+            // In microseconds
+            int64_t totalTime = 0;
+            int64_t maxTime = 0;
+
+            void Add(int64_t time)
+            {
+                calls++;
+                totalTime += time;
+                if(time > maxTime) maxTime = time;
+            }
+        };
+
+        Entry eventHandlers;
+        Entry timers;
+        Entry everyTick;
+        Entry nextTick;
+        // Calls of exported functions by other resources
+        Entry exports;
+        // Time spent evaluating the modules when starting, in microseconds
+        int64_t startTime = 0;
+        // Heap size attributed to the context of the resource in bytes, -1 if it was not measured yet
+        int64_t heapSize = -1;
+        // How late timers ran compared to when they were due, in microseconds
+        CHistogram timerLag;
+    };
+
     V8ResourceImpl(v8::Isolate* _isolate, alt::IResource* _resource) : isolate(_isolate), resource(_resource) {}
 
     ~V8ResourceImpl();
@@ -49,58 +88,50 @@ public:
 
     void SubscribeLocal(const std::string& ev, v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location, bool once = false)
     {
-        localHandlers.insert({ ev, V8Helpers::EventCallback{ isolate, cb, std::move(location), once } });
+        localHandlers.Add(ev, new V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
     }
 
     void SubscribeRemote(const std::string& ev, v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location, bool once = false)
     {
-        remoteHandlers.insert({ ev, V8Helpers::EventCallback{ isolate, cb, std::move(location), once } });
+        remoteHandlers.Add(ev, new V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
     }
 
     void SubscribeGenericLocal(v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location, bool once = false)
     {
-        localGenericHandlers.push_back(V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
+        localGenericHandlers.push_back(new V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
     }
 
     void SubscribeGenericRemote(v8::Local<v8::Function> cb, V8Helpers::SourceLocation&& location, bool once = false)
     {
-        remoteGenericHandlers.push_back(V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
+        remoteGenericHandlers.push_back(new V8Helpers::EventCallback{ isolate, cb, std::move(location), once });
     }
 
     void UnsubscribeLocal(const std::string& ev, v8::Local<v8::Function> cb)
     {
-        auto range = localHandlers.equal_range(ev);
-
-        for(auto it = range.first; it != range.second; ++it)
-        {
-            if(it->second.fn.Get(isolate)->StrictEquals(cb)) it->second.removed = true;
-        }
+        if(localHandlers.Remove(isolate, ev, cb)) hasRemovedHandlers = true;
     }
 
     void UnsubscribeRemote(const std::string& ev, v8::Local<v8::Function> cb)
     {
-        auto range = remoteHandlers.equal_range(ev);
-
-        for(auto it = range.first; it != range.second; ++it)
-        {
-            if(it->second.fn.Get(isolate)->StrictEquals(cb)) it->second.removed = true;
-        }
+        if(remoteHandlers.Remove(isolate, ev, cb)) hasRemovedHandlers = true;
     }
 
     void UnsubscribeGenericLocal(v8::Local<v8::Function> cb)
     {
-        for(auto& it : localGenericHandlers)
+        for(auto it : localGenericHandlers)
         {
-            if(it.fn.Get(isolate)->StrictEquals(cb)) it.removed = true;
+            if(it->fn.Get(isolate)->StrictEquals(cb)) it->removed = true;
         }
+        hasRemovedHandlers = true;
     }
 
     void UnsubscribeGenericRemote(v8::Local<v8::Function> cb)
     {
-        for(auto& it : remoteGenericHandlers)
+        for(auto it : remoteGenericHandlers)
         {
-            if(it.fn.Get(isolate)->StrictEquals(cb)) it.removed = true;
+            if(it->fn.Get(isolate)->StrictEquals(cb)) it->removed = true;
         }
+        hasRemovedHandlers = true;
     }
 
     void DispatchStartEvent(bool error)
@@ -108,19 +139,22 @@ public:
         std::vector<v8::Local<v8::Value>> args;
         args.push_back(V8Helpers::JSValue(error));
 
-        InvokeEventHandlers(nullptr, GetLocalHandlers("resourceStart"), args, true);
+        static V8Helpers::EventNames::Id eventId = V8Helpers::EventNames::Intern("resourceStart");
+        InvokeEventHandlers(nullptr, GetLocalHandlers(eventId), args, true);
     }
 
     void DispatchStopEvent()
     {
         std::vector<v8::Local<v8::Value>> args;
-        InvokeEventHandlers(nullptr, GetLocalHandlers("resourceStop"), args, true);
+        static V8Helpers::EventNames::Id eventId = V8Helpers::EventNames::Intern("resourceStop");
+        InvokeEventHandlers(nullptr, GetLocalHandlers(eventId), args, true);
     }
 
     void DispatchErrorEvent(const std::string& errorMsg, const std::string& file, int32_t line)
     {
         std::vector<v8::Local<v8::Value>> args = { v8::Exception::Error(V8Helpers::JSValue(errorMsg)), V8Helpers::JSValue(file), V8Helpers::JSValue(line) };
-        InvokeEventHandlers(nullptr, GetLocalHandlers("resourceError"), args);
+        static V8Helpers::EventNames::Id eventId = V8Helpers::EventNames::Intern("resourceError");
+        InvokeEventHandlers(nullptr, GetLocalHandlers(eventId), args);
     }
 
     V8Entity* GetEntity(alt::IBaseObject* handle)
@@ -150,6 +184,8 @@ public:
         V8Entity* ent = GetEntity(handle);
 
         if(!ent) ent = CreateEntity(handle);
+        else if(ent->IsCollected())
+            ent->Recreate(GetContext());
 
         return ent;
     }
@@ -166,6 +202,16 @@ public:
     v8::Local<v8::Value> CreateVector2(alt::Vector2f vec);
     v8::Local<v8::Value> CreateRGBA(alt::RGBA rgba);
 
+    // Objects converted from dicts with the same keys in the same order are created from the same template,
+    // so they share their hidden class and the key strings are only created once
+    struct ObjectShape
+    {
+        v8::Global<v8::ObjectTemplate> tpl;
+        std::vector<v8::Global<v8::String>> keys;
+    };
+    // Returns nullptr if objects with the keys of the dict can't be created from a template
+    ObjectShape* GetObjectShape(alt::MValueDictConst& dict);
+
     bool IsVector3(v8::Local<v8::Value> val);
     bool IsVector2(v8::Local<v8::Value> val);
     bool IsRGBA(v8::Local<v8::Value> val);
@@ -184,13 +230,20 @@ public:
     {
         uint32_t id = nextTimerId++;
         // Log::Debug << "Create timer " << id << Log::Endl;
-        timers[id] = new V8Timer{ isolate, context, GetTime(), callback, interval, once, std::move(location) };
+        V8Timer* timer = new V8Timer{ isolate, context, GetTime(), callback, interval, once, std::move(location) };
+        timers[id] = timer;
+
+        if(timer->IsEveryTick()) everyTickTimers.push_back(id);
+        else
+            timerWheel.Schedule(id, timer->GetNextRun());
 
         return id;
     }
 
     void RemoveTimer(uint32_t id)
     {
+        auto it = timers.find(id);
+        if(it != timers.end()) it->second->SetRemoved();
         oldTimers.push_back(id);
     }
 
@@ -216,15 +269,71 @@ public:
                   << ")" << Log::Endl;
     }
 
+    Stats& GetStats()
+    {
+        return stats;
+    }
+    virtual void LogStats();
+
+    // Time limit of a single script execution in milliseconds, 0 disables it
+    uint32_t GetExecutionTimeout() const
+    {
+        return executionTimeout;
+    }
+    void SetExecutionTimeout(uint32_t timeout)
+    {
+        executionTimeout = timeout;
+    }
+
+    // Time in milliseconds the resource start and stop events wait for promises returned by their handlers, 0 waits forever
+    static uint32_t GetAsyncEventTimeout()
+    {
+        return asyncEventTimeout;
+    }
+    static void SetAsyncEventTimeout(uint32_t timeout)
+    {
+        asyncEventTimeout = timeout;
+    }
+
+    // Name of the event in traces, only build it while tracing
+    static std::string GetEventTraceName(const alt::CEvent* ev);
+
+    // Monotonic time in milliseconds, timers and other deadlines of the resource are based on it
+    static int64_t GetTime()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static int64_t GetMicroTime()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
     void NotifyPoolUpdate(alt::IBaseObject* ent);
 
     v8::Local<v8::Array> GetAllPlayers();
     v8::Local<v8::Array> GetAllVehicles();
     v8::Local<v8::Array> GetAllBlips();
 
-    std::vector<V8Helpers::EventCallback*> GetLocalHandlers(const std::string& name);
-    std::vector<V8Helpers::EventCallback*> GetRemoteHandlers(const std::string& name);
-    std::vector<V8Helpers::EventCallback*> GetGenericHandlers(bool local);
+    const std::vector<V8Helpers::EventCallback*>& GetLocalHandlers(V8Helpers::EventNames::Id id)
+    {
+        return localHandlers.Get(id);
+    }
+    const std::vector<V8Helpers::EventCallback*>& GetLocalHandlers(const std::string& name)
+    {
+        return localHandlers.Get(name);
+    }
+    const std::vector<V8Helpers::EventCallback*>& GetRemoteHandlers(V8Helpers::EventNames::Id id)
+    {
+        return remoteHandlers.Get(id);
+    }
+    const std::vector<V8Helpers::EventCallback*>& GetRemoteHandlers(const std::string& name)
+    {
+        return remoteHandlers.Get(name);
+    }
+    const std::vector<V8Helpers::EventCallback*>& GetGenericHandlers(bool local)
+    {
+        return local ? localGenericHandlers : remoteGenericHandlers;
+    }
 
     using NextTickCallback = std::function<void()>;
     void RunOnNextTick(NextTickCallback&& callback)
@@ -232,7 +341,89 @@ public:
         nextTickCallbacks.push_back(callback);
     }
 
+    // Lets other threads run callbacks on the next tick of the resource. Tasks keep a reference to it,
+    // so they can still push their results after the resource stopped, which are then dropped.
+    // The callbacks can be destroyed on any thread, so they must not hold V8 handles
+    class AsyncCallbackQueue
+    {
+        std::mutex lock;
+        std::condition_variable tasksDone;
+        std::vector<NextTickCallback> callbacks;
+        uint32_t runningTasks = 0;
+        bool closed = false;
+
+    public:
+        void Push(NextTickCallback&& callback)
+        {
+            std::scoped_lock guard(lock);
+            if(!closed) callbacks.push_back(std::move(callback));
+        }
+        std::vector<NextTickCallback> Take()
+        {
+            std::vector<NextTickCallback> taken;
+            std::scoped_lock guard(lock);
+            taken.swap(callbacks);
+            return taken;
+        }
+
+        // Tasks working for the resource are tracked from when they are queued until they ended,
+        // so the resource doesn't finish stopping while they still run
+        void BeginTask()
+        {
+            std::scoped_lock guard(lock);
+            runningTasks++;
+        }
+        void EndTask()
+        {
+            std::scoped_lock guard(lock);
+            if(--runningTasks == 0) tasksDone.notify_all();
+        }
+        // Tasks that didn't start yet should skip their work once the resource is stopping
+        bool IsClosed()
+        {
+            std::scoped_lock guard(lock);
+            return closed;
+        }
+
+        // Drops the pending callbacks and waits until the running tasks ended
+        void Close()
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            closed = true;
+            callbacks.clear();
+            tasksDone.wait(guard, [this]() { return runningTasks == 0; });
+        }
+    };
+    std::shared_ptr<AsyncCallbackQueue> GetAsyncCallbackQueue()
+    {
+        return asyncCallbacks;
+    }
+
+    // Promises settled by async callbacks, which refer to them by id because they can't hold the resolver
+    uint32_t AddAsyncPromise(v8::Local<v8::Promise::Resolver> resolver)
+    {
+        uint32_t id = nextAsyncPromiseId++;
+        asyncPromises.insert({ id, V8Helpers::CPersistent<v8::Promise::Resolver>(isolate, resolver) });
+        return id;
+    }
+    v8::Local<v8::Promise::Resolver> TakeAsyncPromise(uint32_t id)
+    {
+        auto it = asyncPromises.find(id);
+        if(it == asyncPromises.end()) return v8::Local<v8::Promise::Resolver>();
+        v8::Local<v8::Promise::Resolver> resolver = it->second.Get(isolate);
+        asyncPromises.erase(it);
+        return resolver;
+    }
+
     v8::Local<v8::Object> GetOrCreateResourceObject(alt::IResource* resource);
+    // Exports of the resource converted to JS, they are only converted again once the resource sets new exports
+    v8::Local<v8::Value> GetResourceExports(alt::IResource* resource);
+    // Drops what is cached for another resource once it stopped, the cached exports would keep its functions alive
+    void OnResourceStopped(alt::IResource* stopped)
+    {
+        resourceObjects.erase(stopped);
+        resourceExports.erase(stopped);
+    }
 
     static V8ResourceImpl* Get(v8::Local<v8::Context> ctx)
     {
@@ -254,13 +445,19 @@ protected:
     std::unordered_map<alt::IBaseObject*, V8Entity*> entities;
     std::unordered_map<uint32_t, V8Timer*> timers;
 
-    std::unordered_multimap<std::string, V8Helpers::EventCallback> localHandlers;
-    std::unordered_multimap<std::string, V8Helpers::EventCallback> remoteHandlers;
-    std::vector<V8Helpers::EventCallback> localGenericHandlers;
-    std::vector<V8Helpers::EventCallback> remoteGenericHandlers;
+    V8Helpers::EventCallbackMap localHandlers;
+    V8Helpers::EventCallbackMap remoteHandlers;
+    std::vector<V8Helpers::EventCallback*> localGenericHandlers;
+    std::vector<V8Helpers::EventCallback*> remoteGenericHandlers;
+    // Removed handlers are only deleted on tick and never while an event is being dispatched
+    bool hasRemovedHandlers = false;
+    uint32_t eventDispatchDepth = 0;
 
     uint32_t nextTimerId = 0;
     std::vector<uint32_t> oldTimers;
+    std::vector<uint32_t> everyTickTimers;
+    std::vector<uint32_t> expiredTimers;
+    CTimerWheel timerWheel{ GetTime() };
 
     bool playerPoolDirty = true;
     v8::UniquePersistent<v8::Array> players;
@@ -275,13 +472,36 @@ protected:
 
     std::unordered_map<alt::IResource*, V8Helpers::CPersistent<v8::Object>> resourceObjects;
 
-    std::vector<NextTickCallback> nextTickCallbacks;
-
-    // TEMP
-    static int64_t GetTime()
+    struct ResourceExports
     {
-        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-    }
+        // Keeps the dict alive, so a new dict can't have the same address
+        alt::MValueDict dict;
+        V8Helpers::CPersistent<v8::Value> value;
+    };
+    std::unordered_map<alt::IResource*, ResourceExports> resourceExports;
 
+    std::vector<NextTickCallback> nextTickCallbacks;
+    std::shared_ptr<AsyncCallbackQueue> asyncCallbacks = std::make_shared<AsyncCallbackQueue>();
+    std::unordered_map<uint32_t, V8Helpers::CPersistent<v8::Promise::Resolver>> asyncPromises;
+    uint32_t nextAsyncPromiseId = 0;
+
+    Stats stats;
+
+    static constexpr size_t MaxObjectShapes = 1024;
+    static constexpr size_t MaxObjectShapeKeys = 32;
+    // Keyed by the keys of the dict joined by '\0'
+    std::unordered_map<std::string, ObjectShape> objectShapes;
+    std::string objectShapeId;
+    uint32_t executionTimeout = CWatchdog::Instance().GetDefaultTimeout();
+    static inline uint32_t asyncEventTimeout = 0;
+
+    void RunTimer(uint32_t id, V8Timer* timer);
+    // Logs a histogram of microsecond values
+    static void LogHistogram(const char* name, const CHistogram& histogram);
+    void WarnSlowCallback(const char* type, V8Helpers::SourceLocation& location, v8::Local<v8::Function> fn, int64_t duration);
+
+    // When waitForPromiseResolve is set, the promise returned by each handler is awaited before the next handler is called
     void InvokeEventHandlers(const alt::CEvent* ev, const std::vector<V8Helpers::EventCallback*>& handlers, std::vector<v8::Local<v8::Value>>& args, bool waitForPromiseResolve = false);
+    // Runs ticks until the promise settled, returns false if the async event timeout passed first
+    bool AwaitPromise(v8::Local<v8::Promise> promise, V8Helpers::EventCallback* handler);
 };
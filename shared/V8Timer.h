@@ -34,6 +34,14 @@ public:
     {
         return location;
     }
+    V8Helpers::SourceLocation& GetLocation()
+    {
+        return location;
+    }
+    v8::Local<v8::Function> GetCallback()
+    {
+        return callback.Get(isolate);
+    }
     int64_t GetInterval()
     {
         return interval;
@@ -42,6 +50,22 @@ public:
     {
         return once;
     }
+    bool IsEveryTick()
+    {
+        return interval == 0 && !once;
+    }
+    int64_t GetNextRun()
+    {
+        return lastRun + interval;
+    }
+    bool IsRemoved()
+    {
+        return removed;
+    }
+    void SetRemoved()
+    {
+        removed = true;
+    }
 
 private:
     v8::Isolate* isolate;
@@ -50,5 +74,6 @@ private:
     int64_t interval;
     int64_t lastRun = 0;
     bool once;
+    bool removed = false;
     V8Helpers::SourceLocation location;
 };
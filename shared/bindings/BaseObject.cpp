@@ -109,3 +109,11 @@ extern V8Class v8BaseObject("BaseObject", [](v8::Local<v8::FunctionTemplate> tpl
 
     V8Helpers::SetAccessor(isolate, tpl, "refCount", RefCountGetter);
 });
+
+// Lets collected entity wrappers be recreated as long as the script didn't add own properties to them.
+// The interceptor slows down every property access, so it is only installed if wrappers are weak
+static void TrackMutations(v8::Local<v8::ObjectTemplate> tpl)
+{
+    if(V8Entity::AreWrappersWeak()) V8Entity::TrackMutations(tpl);
+}
+static bool trackMutations = (v8BaseObject.SetInstanceCallback(&TrackMutations), true);
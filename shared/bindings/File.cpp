@@ -2,6 +2,9 @@
 #include "../V8Helpers.h"
 #include "../V8ResourceImpl.h"
 #include "../V8Class.h"
+#include "../CThreadPool.h"
+
+#include <fstream>
 
 static void StaticExists(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
@@ -22,59 +25,199 @@ static void StaticExists(const v8::FunctionCallbackInfo<v8::Value>& info)
     V8_RETURN_BOOLEAN(exists);
 }
 
-// todo: refactor this
-static void StaticRead(const v8::FunctionCallbackInfo<v8::Value>& info)
+struct ReadRequest
 {
-    V8_GET_ISOLATE_CONTEXT_IRESOURCE();
+    std::string encoding = "utf-8";
+    // Byte range to read, only supported for binary reads
+    int64_t offset = 0;
+    int64_t length = -1;
+#ifdef ALT_CLIENT
+    alt::IPackage* pkg = nullptr;
+#endif
+    alt::String fileName;
+#ifndef ALT_CLIENT
+    // Resolved on the main thread for async reads, which don't use the core
+    std::filesystem::path filePath;
+#endif
+    std::unique_ptr<alt::String> data;
+};
 
-    V8_CHECK_ARGS_LEN_MIN(1);
-    V8_ARG_TO_STRING(1, name);
+// Parses the arguments of read and readAsync, throws and returns false if they are invalid
+static bool GetReadRequest(const v8::FunctionCallbackInfo<v8::Value>& info, alt::IResource* resource, ReadRequest& request)
+{
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> ctx = isolate->GetEnteredOrMicrotaskContext();
 
-    std::string encoding = "utf-8";
+    V8_CHECK_RETN(info.Length() >= 1 && info.Length() <= 4, "Minimum 1, maximum 4 arguments expected", false);
 
+    alt::String name;
+    V8_CHECK_RETN(V8Helpers::SafeToString(info[0], isolate, ctx, name), "Failed to convert argument 1 to string", false);
     if(info.Length() >= 2)
     {
-        V8_ARG_TO_STD_STRING(2, _encoding);
-        encoding = _encoding;
+        V8_CHECK_RETN(V8Helpers::SafeToStdString(info[1], isolate, ctx, request.encoding), "Failed to convert argument 2 to string", false);
+    }
+    if(info.Length() >= 3)
+    {
+        V8_CHECK_RETN(request.encoding == "binary", "A range can only be read with the binary encoding", false);
+        V8_CHECK_RETN(V8Helpers::SafeToInteger(info[2], ctx, request.offset), "Failed to convert argument 3 to integer", false);
+        V8_CHECK_RETN(request.offset >= 0, "Offset has to be positive", false);
+    }
+    if(info.Length() == 4)
+    {
+        V8_CHECK_RETN(V8Helpers::SafeToInteger(info[3], ctx, request.length), "Failed to convert argument 4 to integer", false);
+        V8_CHECK_RETN(request.length >= 0, "Length has to be positive", false);
     }
 
 #ifdef ALT_CLIENT
     alt::String origin = V8Helpers::GetCurrentSourceOrigin(isolate);
     auto path = alt::ICore::Instance().Resolve(resource, name, origin);
-    V8_CHECK(path.pkg, "invalid asset pack");
+    V8_CHECK_RETN(path.pkg, "invalid asset pack", false);
+    request.pkg = path.pkg;
+    request.fileName = path.fileName;
+#else
+    request.fileName = name;
+#endif  // ALT_CLIENT
 
-    alt::IPackage::File* file = path.pkg->OpenFile(path.fileName);
-    V8_CHECK(file, "file does not exist");
+    return true;
+}
 
-    alt::String data(path.pkg->GetFileSize(file));
-    path.pkg->ReadFile(file, data.GetData(), data.GetSize());
-    path.pkg->CloseFile(file);
+// Reads through the core, so it has to run on the main thread. Returns false if the file does not exist
+static bool ReadFileData(ReadRequest& request)
+{
+#ifdef ALT_CLIENT
+    alt::IPackage::File* file = request.pkg->OpenFile(request.fileName);
+    if(!file) return false;
+
+    // Files are read from the start, so the part after the range doesn't have to be read at all
+    uint64_t fileSize = request.pkg->GetFileSize(file);
+    uint64_t readSize = request.length < 0 ? fileSize : std::min<uint64_t>(fileSize, request.offset + request.length);
+    request.data = std::make_unique<alt::String>(readSize);
+    request.pkg->ReadFile(file, request.data->GetData(), request.data->GetSize());
+    request.pkg->CloseFile(file);
 #else
-    alt::String data = alt::ICore::Instance().FileRead(name);
+    // Constructed in place from the returned value, so the data isn't copied
+    request.data.reset(new alt::String(alt::ICore::Instance().FileRead(request.fileName)));
 #endif  // ALT_CLIENT
 
-    if(encoding == "utf-8")
-    {
-        V8_RETURN(V8Helpers::JSValue(data));
-    }
-    else if(encoding == "utf-16")
+    return true;
+}
+
+#ifndef ALT_CLIENT
+// Doesn't use V8 or the core, so it can run on any thread. Only reads the requested range,
+// returns false if the file does not exist
+static bool ReadFileFromDisk(ReadRequest& request)
+{
+    std::ifstream file(request.filePath, std::ios::binary | std::ios::ate);
+    if(!file) return false;
+
+    int64_t size = file.tellg();
+    if(size < 0) return false;
+    int64_t start = std::min(request.offset, size);
+    int64_t end = request.length < 0 || request.length > size - start ? size : start + request.length;
+
+    request.data = std::make_unique<alt::String>((size_t)(end - start));
+    file.seekg(start);
+    file.read(request.data->GetData(), end - start);
+    if(!file) return false;
+
+    // The data is the range now
+    request.offset = 0;
+    request.length = -1;
+    return true;
+}
+#endif  // ALT_CLIENT
+
+// Frees the file data once the array buffer that uses it is collected
+static void DeleteFileData(void*, size_t, void* data)
+{
+    delete static_cast<alt::String*>(data);
+}
+
+static v8::Local<v8::Value> FileDataToV8(v8::Isolate* isolate, ReadRequest& request)
+{
+    if(request.encoding == "binary")
     {
-        V8_RETURN(V8Helpers::JSValue((uint16_t*)data.GetData()));
+        size_t size = request.data->GetSize();
+        size_t start = std::min<size_t>(request.offset, size);
+        size_t end = request.length < 0 ? size : std::min<size_t>(start + request.length, size);
+
+        // A range is copied, so the array buffer doesn't keep all of the read data alive
+        if(start != 0 || end != size)
+        {
+            v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, end - start);
+            std::memcpy(buffer->GetBackingStore()->Data(), request.data->GetData() + start, end - start);
+            return buffer;
+        }
+
+        // The array buffer uses the memory of the read data instead of a copy of it
+        alt::String* data = request.data.release();
+        std::unique_ptr<v8::BackingStore> backingStore = v8::ArrayBuffer::NewBackingStore(data->GetData(), size, &DeleteFileData, data);
+        return v8::ArrayBuffer::New(isolate, std::move(backingStore));
     }
-    else if(encoding == "binary")
-    {
-        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, data.GetSize());
-        auto contents = buffer->GetBackingStore();
+    if(request.encoding == "utf-8") return V8Helpers::JSValue(*request.data);
+    if(request.encoding == "utf-16") return V8Helpers::JSValue((uint16_t*)request.data->GetData());
+    return v8::Undefined(isolate);
+}
 
-        std::memcpy(contents->Data(), data.GetData(), data.GetSize());
+static void StaticRead(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT_IRESOURCE();
 
-        V8_RETURN(buffer);
-    }
+    ReadRequest request;
+    if(!GetReadRequest(info, resource, request)) return;
+    V8_CHECK(ReadFileData(request), "file does not exist");
+
+    V8_RETURN(FileDataToV8(isolate, request));
 }
 
+#ifndef ALT_CLIENT
+static void StaticReadAsync(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT_RESOURCE();
+
+    std::shared_ptr<ReadRequest> request = std::make_shared<ReadRequest>();
+    if(!GetReadRequest(info, resource->GetResource(), *request)) return;
+
+    // Relative paths are read from the server root like the core does
+    request->filePath = std::filesystem::path(request->fileName.ToString());
+    if(request->filePath.is_relative()) request->filePath = std::filesystem::path(alt::ICore::Instance().GetRootDirectory().ToString()) / request->filePath;
+
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(ctx).ToLocalChecked();
+    uint32_t promiseId = resource->AddAsyncPromise(resolver);
+
+    std::shared_ptr<V8ResourceImpl::AsyncCallbackQueue> queue = resource->GetAsyncCallbackQueue();
+    queue->BeginTask();
+    CThreadPool::Instance().Run([request, promiseId, resource, queue]() {
+        if(!queue->IsClosed())
+        {
+            bool exists = ReadFileFromDisk(*request);
+            // Only runs while the resource is still running, so it can be used there
+            queue->Push([request, promiseId, resource, exists]() {
+                v8::Isolate* isolate = resource->GetIsolate();
+                v8::Local<v8::Context> ctx = resource->GetContext();
+
+                v8::Local<v8::Promise::Resolver> resolver = resource->TakeAsyncPromise(promiseId);
+                if(resolver.IsEmpty()) return;
+
+                if(exists) resolver->Resolve(ctx, FileDataToV8(isolate, *request));
+                else
+                    resolver->Reject(ctx, v8::Exception::Error(V8Helpers::JSValue("file does not exist")));
+            });
+        }
+        queue->EndTask();
+    });
+
+    V8_RETURN(resolver->GetPromise());
+}
+#endif  // ALT_CLIENT
+
 extern V8Class v8File("File", [](v8::Local<v8::FunctionTemplate> tpl) {
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
 
     V8Helpers::SetStaticMethod(isolate, tpl, "exists", StaticExists);
     V8Helpers::SetStaticMethod(isolate, tpl, "read", StaticRead);
+#ifndef ALT_CLIENT
+    // Client files are read from packages through the core, which can't be used off the main thread
+    V8Helpers::SetStaticMethod(isolate, tpl, "readAsync", StaticReadAsync);
+#endif
 });
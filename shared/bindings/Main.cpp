@@ -23,14 +23,14 @@ static void On(const v8::FunctionCallbackInfo<v8::Value>& info)
     {
         V8_ARG_TO_FUNCTION(1, callback);
 
-        resource->SubscribeGenericLocal(callback, V8Helpers::SourceLocation::GetCurrent(isolate));
+        resource->SubscribeGenericLocal(callback, V8Helpers::SourceLocation::Capture(isolate));
     }
     else if(info.Length() == 2)
     {
         V8_ARG_TO_STRING(1, evName);
         V8_ARG_TO_FUNCTION(2, callback);
 
-        resource->SubscribeLocal(evName.ToString(), callback, V8Helpers::SourceLocation::GetCurrent(isolate));
+        resource->SubscribeLocal(evName.ToString(), callback, V8Helpers::SourceLocation::Capture(isolate));
     }
 }
 
@@ -43,14 +43,14 @@ static void Once(const v8::FunctionCallbackInfo<v8::Value>& info)
     {
         V8_ARG_TO_FUNCTION(1, callback);
 
-        resource->SubscribeGenericLocal(callback, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+        resource->SubscribeGenericLocal(callback, V8Helpers::SourceLocation::Capture(isolate), true);
     }
     else if(info.Length() == 2)
     {
         V8_ARG_TO_STRING(1, evName);
         V8_ARG_TO_FUNCTION(2, callback);
 
-        resource->SubscribeLocal(evName.ToString(), callback, V8Helpers::SourceLocation::GetCurrent(isolate), true);
+        resource->SubscribeLocal(evName.ToString(), callback, V8Helpers::SourceLocation::Capture(isolate), true);
     }
 }
 
@@ -285,7 +285,7 @@ static void SetTimeout(const v8::FunctionCallbackInfo<v8::Value>& info)
     V8_ARG_TO_FUNCTION(1, callback);
     V8_ARG_TO_INT(2, time);
 
-    V8_RETURN_INT(resource->CreateTimer(ctx, callback, time, true, V8Helpers::SourceLocation::GetCurrent(isolate)));
+    V8_RETURN_INT(resource->CreateTimer(ctx, callback, time, true, V8Helpers::SourceLocation::Capture(isolate)));
 }
 
 static void SetInterval(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -297,7 +297,7 @@ static void SetInterval(const v8::FunctionCallbackInfo<v8::Value>& info)
     V8_ARG_TO_FUNCTION(1, callback);
     V8_ARG_TO_INT(2, time);
 
-    V8_RETURN_INT(resource->CreateTimer(ctx, callback, time, false, V8Helpers::SourceLocation::GetCurrent(isolate)));
+    V8_RETURN_INT(resource->CreateTimer(ctx, callback, time, false, V8Helpers::SourceLocation::Capture(isolate)));
 }
 
 static void NextTick(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -308,7 +308,7 @@ static void NextTick(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     V8_ARG_TO_FUNCTION(1, callback);
 
-    V8_RETURN_INT(resource->CreateTimer(ctx, callback, 0, true, V8Helpers::SourceLocation::GetCurrent(isolate)));
+    V8_RETURN_INT(resource->CreateTimer(ctx, callback, 0, true, V8Helpers::SourceLocation::Capture(isolate)));
 }
 
 static void EveryTick(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -319,7 +319,7 @@ static void EveryTick(const v8::FunctionCallbackInfo<v8::Value>& info)
 
     V8_ARG_TO_FUNCTION(1, callback);
 
-    V8_RETURN_INT(resource->CreateTimer(ctx, callback, 0, false, V8Helpers::SourceLocation::GetCurrent(isolate)));
+    V8_RETURN_INT(resource->CreateTimer(ctx, callback, 0, false, V8Helpers::SourceLocation::Capture(isolate)));
 }
 
 static void ClearTimer(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -354,16 +354,15 @@ static void HasResource(const v8::FunctionCallbackInfo<v8::Value>& info)
 
 static void GetResourceExports(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
-    V8_GET_ISOLATE_CONTEXT();
+    V8_GET_ISOLATE_CONTEXT_RESOURCE();
     V8_CHECK_ARGS_LEN(1);
 
     V8_ARG_TO_STRING(1, name);
 
-    alt::IResource* resource = alt::ICore::Instance().GetResource(name);
-    if(resource)
+    alt::IResource* exportingResource = alt::ICore::Instance().GetResource(name);
+    if(exportingResource)
     {
-        v8::Local<v8::Value> exports = V8Helpers::MValueToV8(resource->GetExports());
-        V8_RETURN(exports);
+        V8_RETURN(resource->GetResourceExports(exportingResource));
     }
 }
 
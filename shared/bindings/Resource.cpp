@@ -2,6 +2,10 @@
 #include "../V8Helpers.h"
 #include "../V8ResourceImpl.h"
 
+#ifdef ALT_SERVER_API
+    #include "CNodeResourceImpl.h"
+#endif
+
 extern V8Class v8Resource;
 
 static void IsStartedGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& info)
@@ -36,7 +40,9 @@ static void ExportsGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<
 {
     V8_GET_ISOLATE_CONTEXT();
     V8_GET_THIS_INTERNAL_FIELD_EXTERNAL(1, resource, alt::IResource);
-    V8_RETURN(V8Helpers::MValueToV8(resource->GetExports()));
+    V8ResourceImpl* currentResource = V8ResourceImpl::Get(ctx);
+    V8_CHECK(currentResource, "invalid resource");
+    V8_RETURN(currentResource->GetResourceExports(resource));
 }
 
 static void DependenciesGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& info)
@@ -144,6 +150,64 @@ static void AllGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::
     V8_RETURN(arr);
 }
 
+static v8::Local<v8::Object> StatsEntryToV8(v8::Isolate* isolate, v8::Local<v8::Context> ctx, const V8ResourceImpl::Stats::Entry& entry)
+{
+    V8_NEW_OBJECT(obj);
+    V8_OBJECT_SET_NUMBER(obj, "calls", (double)entry.calls);
+    V8_OBJECT_SET_NUMBER(obj, "totalTime", entry.totalTime / 1000.0);
+    V8_OBJECT_SET_NUMBER(obj, "maxTime", entry.maxTime / 1000.0);
+    return obj;
+}
+
+// Values of the histogram are in microseconds
+static v8::Local<v8::Object> HistogramToV8(v8::Isolate* isolate, v8::Local<v8::Context> ctx, const CHistogram& histogram)
+{
+    V8_NEW_OBJECT(obj);
+    V8_OBJECT_SET_NUMBER(obj, "samples", (double)histogram.GetCount());
+    V8_OBJECT_SET_NUMBER(obj, "p50", histogram.GetPercentile(50) / 1000.0);
+    V8_OBJECT_SET_NUMBER(obj, "p90", histogram.GetPercentile(90) / 1000.0);
+    V8_OBJECT_SET_NUMBER(obj, "p99", histogram.GetPercentile(99) / 1000.0);
+    V8_OBJECT_SET_NUMBER(obj, "max", histogram.GetMax() / 1000.0);
+    return obj;
+}
+
+static void GetStats(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT();
+
+    // Times are in milliseconds, the heap size in bytes
+    V8_NEW_OBJECT(result);
+    for(alt::IResource* res : alt::ICore::Instance().GetAllResources())
+    {
+        if(!res->IsStarted() || res->GetType() != "js") continue;
+        V8ResourceImpl::Stats& stats = static_cast<V8ResourceImpl*>(res->GetImpl())->GetStats();
+
+        V8_NEW_OBJECT(resourceStats);
+        V8_OBJECT_SET_NUMBER(resourceStats, "startTime", stats.startTime / 1000.0);
+        if(stats.heapSize >= 0) V8_OBJECT_SET_NUMBER(resourceStats, "heapSize", (double)stats.heapSize);
+        resourceStats->Set(ctx, V8Helpers::JSValue("eventHandlers"), StatsEntryToV8(isolate, ctx, stats.eventHandlers));
+        resourceStats->Set(ctx, V8Helpers::JSValue("timers"), StatsEntryToV8(isolate, ctx, stats.timers));
+        resourceStats->Set(ctx, V8Helpers::JSValue("everyTick"), StatsEntryToV8(isolate, ctx, stats.everyTick));
+        resourceStats->Set(ctx, V8Helpers::JSValue("nextTick"), StatsEntryToV8(isolate, ctx, stats.nextTick));
+        resourceStats->Set(ctx, V8Helpers::JSValue("exports"), StatsEntryToV8(isolate, ctx, stats.exports));
+        resourceStats->Set(ctx, V8Helpers::JSValue("timerLag"), HistogramToV8(isolate, ctx, stats.timerLag));
+
+#ifdef ALT_SERVER_API
+        CNodeResourceImpl::LoopStats& loopStats = static_cast<CNodeResourceImpl*>(res->GetImpl())->GetLoopStats();
+        V8_NEW_OBJECT(loop);
+        loop->Set(ctx, V8Helpers::JSValue("uvRunTime"), HistogramToV8(isolate, ctx, loopStats.uvRunTime));
+        loop->Set(ctx, V8Helpers::JSValue("microtaskTime"), HistogramToV8(isolate, ctx, loopStats.microtaskTime));
+        V8_OBJECT_SET_UINT(loop, "activeHandles", loopStats.activeHandles);
+        V8_OBJECT_SET_UINT(loop, "activeRequests", loopStats.activeRequests);
+        resourceStats->Set(ctx, V8Helpers::JSValue("loop"), loop);
+#endif
+
+        result->Set(ctx, V8Helpers::JSValue(res->GetName()), resourceStats);
+    }
+
+    V8_RETURN(result);
+}
+
 static void CurrentGetter(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& info)
 {
     V8_GET_ISOLATE_CONTEXT_RESOURCE();
@@ -171,6 +235,7 @@ extern V8Class v8Resource("Resource", [](v8::Local<v8::FunctionTemplate> tpl) {
 #endif
 
     V8Helpers::SetStaticMethod(isolate, tpl, "getByName", &GetByName);
+    V8Helpers::SetStaticMethod(isolate, tpl, "getStats", &GetStats);
     V8Helpers::SetStaticAccessor(isolate, tpl, "all", &AllGetter);
     V8Helpers::SetStaticAccessor(isolate, tpl, "current", &CurrentGetter);
 });
@@ -1,4 +1,70 @@
+#include "../V8Helpers.h"
+#include "../V8ResourceImpl.h"
 #include "../V8Class.h"
 
-// Bindings are added here from JS
-extern V8Class v8Utils("Utils", [](v8::Local<v8::FunctionTemplate> tpl) {});
+#ifdef ALT_CLIENT_API
+    #include "CV8Resource.h"
+
+static void StaticRequestAssets(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    V8_GET_ISOLATE_CONTEXT_RESOURCE();
+    V8_CHECK_ARGS_LEN2(1, 2);
+
+    V8_ARG_TO_ARRAY(1, arr);
+    uint32_t timeout = 1000;
+    if(info.Length() == 2)
+    {
+        V8_ARG_TO_UINT(2, _timeout);
+        timeout = _timeout;
+    }
+
+    std::vector<V8Helpers::AssetRequests::Asset> assets;
+    assets.reserve(arr->Length());
+    for(uint32_t i = 0; i < arr->Length(); i++)
+    {
+        v8::Local<v8::Value> val;
+        v8::Local<v8::Object> obj;
+        V8_CHECK(arr->Get(ctx, i).ToLocal(&val) && V8Helpers::SafeToObject(val, ctx, obj), "Expected an array of assets");
+
+        V8Helpers::AssetRequests::Asset asset;
+        std::string type;
+        V8_CHECK(V8Helpers::SafeToStdString(obj->Get(ctx, V8Helpers::JSValue("type")).ToLocalChecked(), isolate, ctx, type), "Asset type has to be a string");
+        V8_CHECK(V8Helpers::AssetRequests::GetType(type, asset.type), "Unknown asset type '" + type + "'");
+
+        v8::Local<v8::Value> name = obj->Get(ctx, V8Helpers::JSValue("name")).ToLocalChecked();
+        if(asset.type == V8Helpers::AssetRequests::Type::MODEL && name->IsNumber())
+        {
+            V8_CHECK(V8Helpers::SafeToUInt32(name, ctx, asset.hash), "Invalid model hash");
+            asset.name = std::to_string(asset.hash);
+        }
+        else
+        {
+            V8_CHECK(V8Helpers::SafeToStdString(name, isolate, ctx, asset.name), "Asset name has to be a string");
+            if(asset.type == V8Helpers::AssetRequests::Type::MODEL) asset.hash = alt::ICore::Instance().Hash(asset.name.c_str());
+        }
+
+        if(asset.type == V8Helpers::AssetRequests::Type::CUTSCENE)
+        {
+            v8::Local<v8::Value> flags = obj->Get(ctx, V8Helpers::JSValue("flags")).ToLocalChecked();
+            if(!flags->IsUndefined())
+            {
+                V8_CHECK(V8Helpers::SafeToInt32(flags, ctx, asset.flags), "Cutscene flags have to be a number");
+            }
+        }
+
+        assets.push_back(std::move(asset));
+    }
+
+    CV8ResourceImpl* clientResource = static_cast<CV8ResourceImpl*>(resource);
+    V8_RETURN(clientResource->GetAssetRequests().Add(clientResource, std::move(assets), timeout));
+}
+#endif  // ALT_CLIENT_API
+
+// Most bindings are added here from JS
+extern V8Class v8Utils("Utils", [](v8::Local<v8::FunctionTemplate> tpl) {
+#ifdef ALT_CLIENT_API
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+
+    V8Helpers::SetStaticMethod(isolate, tpl, "requestAssets", StaticRequestAssets);
+#endif
+});
@@ -14,13 +14,7 @@ if(alt.isClient) {
             ? `Model '${_model}', with hash ${alt.hash(_model)} is invalid`
             : `Model ${_model} is invalid`);
 
-        const checkUntil = Date.now() + timeout;
-        native.requestModel(model);
-
-        while (!native.hasModelLoaded(model)) {
-            if (Date.now() > checkUntil) throw new Error(`Failed to request model '${_model}'`);
-            await alt.Utils.wait(5);
-        }
+        return alt.Utils.requestAssets([{ type: "model", name: _model }], timeout);
     }
 
     alt.Utils.requestAnimDict = async function(animDict, timeout = 1000) {
@@ -29,39 +23,21 @@ if(alt.isClient) {
 
         if (!native.doesAnimDictExist(animDict)) throw new Error(`Anim dict '${animDict}' not valid`);
 
-        const checkUntil = Date.now() + timeout;
-        native.requestAnimDict(animDict);
-
-        while (!native.hasAnimDictLoaded(animDict)) {
-            if (Date.now() > checkUntil) throw new Error(`Failed to request anim dict '${animDict}'`);
-            await alt.Utils.wait(5);
-        }
+        return alt.Utils.requestAssets([{ type: "animDict", name: animDict }], timeout);
     }
 
     alt.Utils.requestAnimSet = async function(animSet, timeout = 1000) {
         if (typeof animSet !== "string") throw new Error("Expected a string as first argument");
         if (typeof timeout !== "number") throw new Error("Expected a number as second argument");
 
-        const checkUntil = Date.now() + timeout;
-        native.requestAnimSet(animSet);
-
-        while (!native.hasAnimSetLoaded(animSet)) {
-            if (Date.now() > checkUntil) throw new Error(`Failed to request anim set '${animSet}'`);
-            await alt.Utils.wait(5);
-        }
+        return alt.Utils.requestAssets([{ type: "animSet", name: animSet }], timeout);
     }
 
     alt.Utils.requestClipSet = async function(clipSet, timeout = 1000) {
         if (typeof clipSet !== "string") throw new Error("Expected a string as first argument");
         if (typeof timeout !== "number") throw new Error("Expected a number as second argument");
 
-        const checkUntil = Date.now() + timeout;
-        native.requestClipSet(clipSet);
-
-        while (!native.hasClipSetLoaded(clipSet)) {
-            if (Date.now() > checkUntil) throw new Error(`Failed to request clip set '${clipSet}'`);
-            await alt.Utils.wait(5);
-        }
+        return alt.Utils.requestAssets([{ type: "clipSet", name: clipSet }], timeout);
     }
 
     alt.Utils.requestCutscene = async function(cutsceneName, flags, timeout = 1000) {
@@ -70,13 +46,7 @@ if(alt.isClient) {
             throw new Error("Expected a number or string as second argument");
         if (typeof timeout !== "number") throw new Error("Expected a number as third argument");
 
-        const checkUntil = Date.now() + timeout;
-        native.requestCutscene(cutsceneName, typeof flags === "string" ? parseInt(flags) : flags);
-
-        while (!native.hasCutsceneLoaded(cutsceneName)) {
-            if (Date.now() > checkUntil) throw new Error(`Failed to request cutscene '${cutsceneName}'`);
-            await alt.Utils.wait(5);
-        }
+        return alt.Utils.requestAssets([{ type: "cutscene", name: cutsceneName, flags: typeof flags === "string" ? parseInt(flags) : flags }], timeout);
     }
 }
 // Server only
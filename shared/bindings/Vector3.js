@@ -21,156 +21,77 @@ Object.defineProperty(alt.Vector3.prototype, "length", {
     }
 });
 
-// Instance methods
-alt.Vector3.prototype.toString = function() {
-    return `Vector3{ x: ${this.x.toFixed(4)}, y: ${this.y.toFixed(4)}, z: ${this.z.toFixed(4)} }`;
-}
+// Components parsed by parseVector3Args, reused so the math methods don't allocate for their arguments
+const vector3Args = { x: 0, y: 0, z: 0 };
 
-alt.Vector3.prototype.toArray = function() {
-    return [this.x, this.y, this.z];
+function parseVector3Component(value) {
+    return typeof value === "number" ? value : parseFloat(value);
 }
 
-alt.Vector3.prototype.add = function(...args) {
-    if(args.length !== 1 && args.length !== 3) throw new Error("1 or 3 arguments expected");
-
-    let x = 0, y = 0, z = 0;
-
-    if(args.length === 3) [x, y, z] = args;
-    else {
-        if(typeof args[0] === "number" || typeof args[0] === "string") x = parseFloat(args[0]), y = parseFloat(args[0]), z = parseFloat(args[0]);
-        else if(Array.isArray(args[0])) {
-            if(typeof args[0][0] === "number" || typeof args[0][0] === "string") x = parseFloat(args[0][0]);
-            if(typeof args[0][1] === "number" || typeof args[0][1] === "string") y = parseFloat(args[0][1]);
-            if(typeof args[0][2] === "number" || typeof args[0][2] === "string") z = parseFloat(args[0][2]);
-        }
-        else if(typeof args[0] === "object") {
-            if(args[0].x !== undefined) x = parseFloat(args[0].x);
-            if(args[0].y !== undefined) y = parseFloat(args[0].y);
-            if(args[0].z !== undefined) z = parseFloat(args[0].z);
-        }
-        else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
+// Parses the arguments of the variadic Vector3 methods (x, y, z | number | number[] | IVector3) into vector3Args
+function parseVector3Args(length, a, b, c) {
+    if(length === 3) {
+        vector3Args.x = a, vector3Args.y = b, vector3Args.z = c;
+        return;
     }
-
-    return new alt.Vector3(this.x + x, this.y + y, this.z + z);
-}
-
-alt.Vector3.prototype.sub = function(...args) {
-    if(args.length !== 1 && args.length !== 3) throw new Error("1 or 3 arguments expected");
+    if(length !== 1) throw new Error("1 or 3 arguments expected");
 
     let x = 0, y = 0, z = 0;
-
-    if(args.length === 3) [x, y, z] = args;
-    else {
-        if(typeof args[0] === "number" || typeof args[0] === "string") x = parseFloat(args[0]), y = parseFloat(args[0]), z = parseFloat(args[0]);
-        else if(Array.isArray(args[0])) {
-            if(typeof args[0][0] === "number" || typeof args[0][0] === "string") x = parseFloat(args[0][0]);
-            if(typeof args[0][1] === "number" || typeof args[0][1] === "string") y = parseFloat(args[0][1]);
-            if(typeof args[0][2] === "number" || typeof args[0][2] === "string") z = parseFloat(args[0][2]);
-        }
-        else if(typeof args[0] === "object") {
-            if(args[0].x !== undefined) x = parseFloat(args[0].x);
-            if(args[0].y !== undefined) y = parseFloat(args[0].y);
-            if(args[0].z !== undefined) z = parseFloat(args[0].z);
-        }
-        else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
+    if(typeof a === "number") x = a, y = a, z = a;
+    else if(typeof a === "string") x = parseFloat(a), y = x, z = x;
+    else if(Array.isArray(a)) {
+        if(typeof a[0] === "number" || typeof a[0] === "string") x = parseVector3Component(a[0]);
+        if(typeof a[1] === "number" || typeof a[1] === "string") y = parseVector3Component(a[1]);
+        if(typeof a[2] === "number" || typeof a[2] === "string") z = parseVector3Component(a[2]);
     }
-
-    return new alt.Vector3(this.x - x, this.y - y, this.z - z);
-}
-
-alt.Vector3.prototype.div = function(...args) {
-    if(args.length !== 1 && args.length !== 3) throw new Error("1 or 3 arguments expected");
-
-    let x = 0, y = 0, z = 0;
-
-    if(args.length === 3) [x, y, z] = args;
-    else {
-        if(typeof args[0] === "number" || typeof args[0] === "string") x = parseFloat(args[0]), y = parseFloat(args[0]), z = parseFloat(args[0]);
-        else if(Array.isArray(args[0])) {
-            if(typeof args[0][0] === "number" || typeof args[0][0] === "string") x = parseFloat(args[0][0]);
-            if(typeof args[0][1] === "number" || typeof args[0][1] === "string") y = parseFloat(args[0][1]);
-            if(typeof args[0][2] === "number" || typeof args[0][2] === "string") z = parseFloat(args[0][2]);
-        }
-        else if(typeof args[0] === "object") {
-            if(args[0].x !== undefined) x = parseFloat(args[0].x);
-            if(args[0].y !== undefined) y = parseFloat(args[0].y);
-            if(args[0].z !== undefined) z = parseFloat(args[0].z);
-        }
-        else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
+    else if(typeof a === "object") {
+        if(a.x !== undefined) x = parseVector3Component(a.x);
+        if(a.y !== undefined) y = parseVector3Component(a.y);
+        if(a.z !== undefined) z = parseVector3Component(a.z);
     }
+    else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
 
-    return new alt.Vector3(this.x / x, this.y / y, this.z / z);
+    // Assigned last, reading the properties above can run getters that use vector3Args themselves
+    vector3Args.x = x, vector3Args.y = y, vector3Args.z = z;
 }
 
-alt.Vector3.prototype.mul = function(...args) {
-    if(args.length !== 1 && args.length !== 3) throw new Error("1 or 3 arguments expected");
-
-    let x = 0, y = 0, z = 0;
-
-    if(args.length === 3) [x, y, z] = args;
-    else {
-        if(typeof args[0] === "number" || typeof args[0] === "string") x = parseFloat(args[0]), y = parseFloat(args[0]), z = parseFloat(args[0]);
-        else if(Array.isArray(args[0])) {
-            if(typeof args[0][0] === "number" || typeof args[0][0] === "string") x = parseFloat(args[0][0]);
-            if(typeof args[0][1] === "number" || typeof args[0][1] === "string") y = parseFloat(args[0][1]);
-            if(typeof args[0][2] === "number" || typeof args[0][2] === "string") z = parseFloat(args[0][2]);
-        }
-        else if(typeof args[0] === "object") {
-            if(args[0].x !== undefined) x = parseFloat(args[0].x);
-            if(args[0].y !== undefined) y = parseFloat(args[0].y);
-            if(args[0].z !== undefined) z = parseFloat(args[0].z);
-        }
-        else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
-    }
-
-    return new alt.Vector3(this.x * x, this.y * y, this.z * z);
+// Instance methods
+alt.Vector3.prototype.toString = function() {
+    return `Vector3{ x: ${this.x.toFixed(4)}, y: ${this.y.toFixed(4)}, z: ${this.z.toFixed(4)} }`;
 }
 
-alt.Vector3.prototype.dot = function(...args) {
-    if(args.length !== 1 && args.length !== 3) throw new Error("1 or 3 arguments expected");
-
-    let x = 0, y = 0, z = 0;
+alt.Vector3.prototype.toArray = function() {
+    return [this.x, this.y, this.z];
+}
 
-    if(args.length === 3) [x, y, z] = args;
-    else {
-        if(typeof args[0] === "number" || typeof args[0] === "string") x = parseFloat(args[0]), y = parseFloat(args[0]), z = parseFloat(args[0]);
-        else if(Array.isArray(args[0])) {
-            if(typeof args[0][0] === "number" || typeof args[0][0] === "string") x = parseFloat(args[0][0]);
-            if(typeof args[0][1] === "number" || typeof args[0][1] === "string") y = parseFloat(args[0][1]);
-            if(typeof args[0][2] === "number" || typeof args[0][2] === "string") z = parseFloat(args[0][2]);
-        }
-        else if(typeof args[0] === "object") {
-            if(args[0].x !== undefined) x = parseFloat(args[0].x);
-            if(args[0].y !== undefined) y = parseFloat(args[0].y);
-            if(args[0].z !== undefined) z = parseFloat(args[0].z);
-        }
-        else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
-    }
+alt.Vector3.prototype.add = function(x, y, z) {
+    parseVector3Args(arguments.length, x, y, z);
+    return new alt.Vector3(this.x + vector3Args.x, this.y + vector3Args.y, this.z + vector3Args.z);
+}
 
-    return (this.x * x) + (this.y * y) + (this.z * z);
+alt.Vector3.prototype.sub = function(x, y, z) {
+    parseVector3Args(arguments.length, x, y, z);
+    return new alt.Vector3(this.x - vector3Args.x, this.y - vector3Args.y, this.z - vector3Args.z);
 }
 
-alt.Vector3.prototype.cross = function(...args) {
-    if(args.length !== 1 && args.length !== 3) throw new Error("1 or 3 arguments expected");
+alt.Vector3.prototype.div = function(x, y, z) {
+    parseVector3Args(arguments.length, x, y, z);
+    return new alt.Vector3(this.x / vector3Args.x, this.y / vector3Args.y, this.z / vector3Args.z);
+}
 
-    let x = 0, y = 0, z = 0;
+alt.Vector3.prototype.mul = function(x, y, z) {
+    parseVector3Args(arguments.length, x, y, z);
+    return new alt.Vector3(this.x * vector3Args.x, this.y * vector3Args.y, this.z * vector3Args.z);
+}
 
-    if(args.length === 3) [x, y, z] = args;
-    else {
-        if(typeof args[0] === "number" || typeof args[0] === "string") x = parseFloat(args[0]), y = parseFloat(args[0]), z = parseFloat(args[0]);
-        else if(Array.isArray(args[0])) {
-            if(typeof args[0][0] === "number" || typeof args[0][0] === "string") x = parseFloat(args[0][0]);
-            if(typeof args[0][1] === "number" || typeof args[0][1] === "string") y = parseFloat(args[0][1]);
-            if(typeof args[0][2] === "number" || typeof args[0][2] === "string") z = parseFloat(args[0][2]);
-        }
-        else if(typeof args[0] === "object") {
-            if(args[0].x !== undefined) x = parseFloat(args[0].x);
-            if(args[0].y !== undefined) y = parseFloat(args[0].y);
-            if(args[0].z !== undefined) z = parseFloat(args[0].z);
-        }
-        else throw new Error("Argument must be a number, an array of 3 numbers or IVector3");
-    }
+alt.Vector3.prototype.dot = function(x, y, z) {
+    parseVector3Args(arguments.length, x, y, z);
+    return (this.x * vector3Args.x) + (this.y * vector3Args.y) + (this.z * vector3Args.z);
+}
 
+alt.Vector3.prototype.cross = function(x, y, z) {
+    parseVector3Args(arguments.length, x, y, z);
+    x = vector3Args.x, y = vector3Args.y, z = vector3Args.z;
     return new alt.Vector3((this.y * z) - (z * this.y), (this.z * x) - (this.x * z), (this.x * y) - (this.y * x));
 }
 
@@ -179,7 +100,7 @@ alt.Vector3.prototype.negative = function() {
 }
 
 alt.Vector3.prototype.normalize = function() {
-    const length = this.length;
+    const length = Math.sqrt(this.x * this.x + this.y * this.y + this.z * this.z);
     return new alt.Vector3(this.x / length, this.y / length, this.z / length);
 }
 
@@ -189,9 +110,9 @@ alt.Vector3.prototype.distanceTo = function(vector) {
 
 alt.Vector3.prototype.distanceToSquared = function(vector) {
     if(vector === undefined) throw new Error("1 argument expected");
-    const x = this.x - parseFloat(vector.x);
-    const y = this.y - parseFloat(vector.y);
-    const z = this.z - parseFloat(vector.z);
+    const x = this.x - parseVector3Component(vector.x);
+    const y = this.y - parseVector3Component(vector.y);
+    const z = this.z - parseVector3Component(vector.z);
     return x * x + y * y + z * z;
 }
 
@@ -219,9 +140,9 @@ alt.Vector3.prototype.toRadians = function() {
 
 alt.Vector3.prototype.isInRange = function(vector, range) {
     if(vector === undefined || range === undefined) throw new Error("2 arguments expected");
-    const x = Math.abs(this.x - parseFloat(vector.x));
-    const y = Math.abs(this.y - parseFloat(vector.y));
-    const z = Math.abs(this.z - parseFloat(vector.z));
+    const x = Math.abs(this.x - parseVector3Component(vector.x));
+    const y = Math.abs(this.y - parseVector3Component(vector.y));
+    const z = Math.abs(this.z - parseVector3Component(vector.z));
 
     return x <= range && y <= range && z <= range  // Fast check
         && x * x + y * y + z * z <= range * range; // Slow check
@@ -136,4 +136,43 @@ namespace V8Helpers
     {
         V8Helpers::SetMethod(isolate, tpl, name, V8Helpers::detail::WrapMethod<T, Method>);
     }
+
+    // Amount of floats written per entity by GetTransforms: id, x, y, z, rx, ry, rz
+    static constexpr uint32_t EntityTransformSize = 7;
+
+    // Writes the transforms of the entities into the Float32Array passed as first argument
+    // and returns the amount of entities written, entities that don't fit into the array are skipped
+    template<class T>
+    inline void GetTransforms(const v8::FunctionCallbackInfo<v8::Value>& info, const alt::Array<alt::Ref<T>>& entities)
+    {
+        V8_GET_ISOLATE();
+        V8_CHECK_ARGS_LEN(1);
+        V8_CHECK(info[0]->IsFloat32Array(), "Float32Array expected");
+
+        v8::Local<v8::Float32Array> arr = info[0].As<v8::Float32Array>();
+        float* data = reinterpret_cast<float*>(static_cast<uint8_t*>(arr->Buffer()->GetBackingStore()->Data()) + arr->ByteOffset());
+        size_t capacity = arr->Length() / EntityTransformSize;
+
+        uint32_t count = 0;
+        for(uint32_t i = 0; i < entities.GetSize() && count < capacity; ++i)
+        {
+            const alt::Ref<T>& entity = entities[i];
+            if(!entity) continue;
+
+            alt::Position pos = entity->GetPosition();
+            alt::Rotation rot = entity->GetRotation();
+
+            float* out = data + count * EntityTransformSize;
+            out[0] = entity->GetID();
+            out[1] = pos[0];
+            out[2] = pos[1];
+            out[3] = pos[2];
+            out[4] = rot[0];
+            out[5] = rot[1];
+            out[6] = rot[2];
+            count++;
+        }
+
+        V8_RETURN_UINT(count);
+    }
 }  // namespace V8Helpers
@@ -39,13 +39,22 @@ alt::MValue V8Helpers::V8ToMValue(v8::Local<v8::Value> val, bool allowFunction)
         if(val->IsArray())
         {
             v8::Local<v8::Array> v8Arr = val.As<v8::Array>();
-            alt::MValueList list = core.CreateMValueList(v8Arr->Length());
+            uint32_t length = v8Arr->Length();
+            alt::MValueList list = core.CreateMValueList(length);
 
-            for(uint32_t i = 0; i < v8Arr->Length(); ++i)
+            for(uint32_t i = 0; i < length; ++i)
             {
                 v8::Local<v8::Value> value;
                 if(!v8Arr->Get(ctx, i).ToLocal(&value)) continue;
-                list->Set(i, V8ToMValue(value, allowFunction));
+
+                // Numbers and booleans make up most large lists, so they skip the generic conversion
+                if(value->IsInt32()) list->Set(i, core.CreateMValueInt(value.As<v8::Int32>()->Value()));
+                else if(value->IsNumber() && !value->IsUint32())
+                    list->Set(i, core.CreateMValueDouble(value.As<v8::Number>()->Value()));
+                else if(value->IsBoolean())
+                    list->Set(i, core.CreateMValueBool(value->IsTrue()));
+                else
+                    list->Set(i, V8ToMValue(value, allowFunction));
             }
 
             return list;
@@ -187,20 +196,56 @@ v8::Local<v8::Value> V8Helpers::MValueToV8(alt::MValueConst val)
         case alt::IMValue::Type::LIST:
         {
             alt::MValueListConst list = val.As<alt::IMValueList>();
-            v8::Local<v8::Array> v8Arr = v8::Array::New(isolate, list->GetSize());
+            uint32_t size = (uint32_t)list->GetSize();
 
-            for(uint32_t i = 0; i < list->GetSize(); ++i) v8Arr->Set(ctx, i, MValueToV8(list->Get(i)));
+            // Creating the array from all elements at once is a lot faster than setting them one by one
+            std::vector<v8::Local<v8::Value>> elements;
+            elements.reserve(size);
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                alt::MValueConst element = list->Get(i);
+                switch(element->GetType())
+                {
+                    case alt::IMValue::Type::DOUBLE: elements.push_back(v8::Number::New(isolate, element.As<alt::IMValueDouble>()->Value())); break;
+                    case alt::IMValue::Type::BOOL: elements.push_back(v8::Boolean::New(isolate, element.As<alt::IMValueBool>()->Value())); break;
+                    case alt::IMValue::Type::INT:
+                    {
+                        int64_t _val = element.As<alt::IMValueInt>()->Value();
+                        if(_val >= INT_MIN && _val <= INT_MAX)
+                        {
+                            elements.push_back(v8::Integer::New(isolate, (int32_t)_val));
+                            break;
+                        }
+                        elements.push_back(MValueToV8(element));
+                        break;
+                    }
+                    default: elements.push_back(MValueToV8(element));
+                }
+            }
 
-            return v8Arr;
+            return v8::Array::New(isolate, elements.data(), elements.size());
         }
         case alt::IMValue::Type::DICT:
         {
             alt::MValueDictConst dict = val.As<alt::IMValueDict>();
-            v8::Local<v8::Object> v8Obj = v8::Object::New(isolate);
+            V8ResourceImpl* resource = V8ResourceImpl::Get(ctx);
+            V8ResourceImpl::ObjectShape* shape = resource ? resource->GetObjectShape(dict) : nullptr;
+            if(shape)
+            {
+                // The properties already exist on the instance, so they are only overwritten without changing its hidden class
+                v8::Local<v8::Object> v8Obj = shape->tpl.Get(isolate)->NewInstance(ctx).ToLocalChecked();
+                size_t i = 0;
+                for(auto it = dict->Begin(); it; it = dict->Next(), i++)
+                {
+                    v8Obj->CreateDataProperty(ctx, shape->keys[i].Get(isolate), MValueToV8(it->GetValue()));
+                }
+                return v8Obj;
+            }
 
+            v8::Local<v8::Object> v8Obj = v8::Object::New(isolate);
             for(auto it = dict->Begin(); it; it = dict->Next())
             {
-                v8Obj->Set(ctx, V8Helpers::JSValue(it->GetKey()), MValueToV8(it->GetValue()));
+                v8Obj->CreateDataProperty(ctx, V8Helpers::JSValue(it->GetKey()), MValueToV8(it->GetValue()));
             }
 
             return v8Obj;
@@ -241,6 +286,7 @@ v8::Local<v8::Value> V8Helpers::MValueToV8(alt::MValueConst val)
 
 void V8Helpers::MValueArgsToV8(alt::MValueArgs args, std::vector<v8::Local<v8::Value>>& v8Args)
 {
+    CTracer::Scope traceScope("mvalue", "MValueArgsToV8");
     for(uint64_t i = 0; i < args.GetSize(); ++i) v8Args.push_back(MValueToV8(args[i]));
 }
 
@@ -394,16 +440,55 @@ static inline v8::MaybeLocal<v8::Object> ReadRawValue(v8::Local<v8::Context> ctx
 
 class WriteDelegate : public v8::ValueSerializer::Delegate
 {
-    v8::ValueSerializer* serializer;
+    // Buffers above this size are freed after use instead of being kept for the next value
+    static constexpr size_t MaxPooledBufferSize = 1024 * 1024;
+
+    v8::ValueSerializer* serializer = nullptr;
+    // The serializer only ever holds one buffer, which is reused for every value written with a pooled delegate
+    uint8_t* buffer = nullptr;
+    size_t bufferSize = 0;
+    bool pooled;
 
 public:
-    WriteDelegate() {}
+    WriteDelegate(bool _pooled) : pooled(_pooled) {}
+    ~WriteDelegate()
+    {
+        free(buffer);
+    }
 
     void SetSerializer(v8::ValueSerializer* _serializer)
     {
         serializer = _serializer;
     }
 
+    void* ReallocateBufferMemory(void* oldBuffer, size_t size, size_t* actualSize) override
+    {
+        if(size > bufferSize)
+        {
+            // Keeps the contents if the serializer is already writing into the buffer
+            void* newBuffer = realloc(buffer, size);
+            if(!newBuffer) return nullptr;
+            buffer = (uint8_t*)newBuffer;
+            bufferSize = size;
+        }
+        *actualSize = bufferSize;
+        return buffer;
+    }
+
+    void FreeBufferMemory(void*) override
+    {
+        ReleaseBuffer();
+    }
+
+    // Has to be called once the released buffer of the serializer is not used anymore
+    void ReleaseBuffer()
+    {
+        if(pooled && bufferSize <= MaxPooledBufferSize) return;
+        free(buffer);
+        buffer = nullptr;
+        bufferSize = 0;
+    }
+
     void ThrowDataCloneError(v8::Local<v8::String> message) override
     {
         V8Helpers::Throw(v8::Isolate::GetCurrent(), V8Helpers::CppValue(message));
@@ -443,17 +528,8 @@ public:
     }
 };
 
-// Converts a JS value to a MValue byte array
-alt::MValueByteArray V8Helpers::V8ToRawBytes(v8::Local<v8::Value> val)
+static alt::MValueByteArray WriteRawBytes(v8::Isolate* isolate, v8::Local<v8::Context> ctx, v8::Local<v8::Value> val, WriteDelegate& delegate)
 {
-    static WriteDelegate delegate;
-
-    v8::Isolate* isolate = v8::Isolate::GetCurrent();
-    v8::Local<v8::Context> ctx = isolate->GetEnteredOrMicrotaskContext();
-
-    RawValueType type = GetValueType(ctx, val);
-    if(type == RawValueType::INVALID) return alt::MValueByteArray();
-
     v8::ValueSerializer serializer(isolate, &delegate);
     delegate.SetSerializer(&serializer);
 
@@ -466,8 +542,37 @@ alt::MValueByteArray V8Helpers::V8ToRawBytes(v8::Local<v8::Value> val)
     bool result;
     if(!serializer.WriteValue(ctx, val).To(&result) || !result) return alt::MValueByteArray();
 
+    // The byte array copies the data, so the buffer can be reused right away
     std::pair<uint8_t*, size_t> serialized = serializer.Release();
-    return alt::ICore::Instance().CreateMValueByteArray(serialized.first, serialized.second);
+    alt::MValueByteArray bytes = alt::ICore::Instance().CreateMValueByteArray(serialized.first, serialized.second);
+    delegate.ReleaseBuffer();
+    return bytes;
+}
+
+// Converts a JS value to a MValue byte array
+alt::MValueByteArray V8Helpers::V8ToRawBytes(v8::Local<v8::Value> val)
+{
+    // Getters of the value run while it is written and can serialize values again. Only the outermost call
+    // of a thread uses the pooled buffer, so nested calls can't move or free it while it is written into
+    static thread_local WriteDelegate pooledDelegate(true);
+    static thread_local bool pooledDelegateInUse = false;
+
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::Local<v8::Context> ctx = isolate->GetEnteredOrMicrotaskContext();
+
+    RawValueType type = GetValueType(ctx, val);
+    if(type == RawValueType::INVALID) return alt::MValueByteArray();
+
+    if(pooledDelegateInUse)
+    {
+        WriteDelegate delegate(false);
+        return WriteRawBytes(isolate, ctx, val, delegate);
+    }
+
+    pooledDelegateInUse = true;
+    alt::MValueByteArray bytes = WriteRawBytes(isolate, ctx, val, pooledDelegate);
+    pooledDelegateInUse = false;
+    return bytes;
 }
 
 // Converts a MValue byte array to a JS value
@@ -0,0 +1,88 @@
+// Micro-benchmark comparing the per tick cost of idle timers when walking all timers linearly
+// (the previous V8ResourceImpl implementation) and when using the timer wheel.
+//
+// Build: c++ -O2 -std=c++17 -I../shared timer-benchmark.cpp -o timer-benchmark
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "CTimerWheel.h"
+
+static constexpr uint32_t TimerCount = 10000;
+static constexpr uint32_t TickCount = 10000;
+// Long enough that none of the timers fire while benchmarking
+static constexpr int64_t TimerInterval = 60 * 60 * 1000;
+
+static int64_t GetTime()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct LinearTimer
+{
+    int64_t interval;
+    int64_t lastRun;
+    uint64_t calls = 0;
+
+    bool Update(int64_t curTime)
+    {
+        if(curTime - lastRun >= interval)
+        {
+            calls++;
+            lastRun = curTime;
+        }
+        return true;
+    }
+};
+
+static double BenchmarkLinear()
+{
+    std::unordered_map<uint32_t, LinearTimer*> timers;
+    for(uint32_t i = 0; i < TimerCount; i++) timers[i] = new LinearTimer{ TimerInterval, GetTime() };
+
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t tick = 0; tick < TickCount; tick++)
+    {
+        for(auto& p : timers)
+        {
+            int64_t time = GetTime();
+            p.second->Update(time);
+            if(GetTime() - time > 10) std::printf("Timer was too long\n");
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for(auto& p : timers) delete p.second;
+    return std::chrono::duration<double, std::micro>(end - start).count() / TickCount;
+}
+
+static double BenchmarkWheel()
+{
+    CTimerWheel wheel{ GetTime() };
+    std::vector<CTimerWheel::TimerId> expired;
+    for(uint32_t i = 0; i < TimerCount; i++) wheel.Schedule(i, GetTime() + TimerInterval);
+
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t tick = 0; tick < TickCount; tick++)
+    {
+        wheel.Advance(GetTime(), expired);
+        expired.clear();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / TickCount;
+}
+
+int main()
+{
+    double linear = BenchmarkLinear();
+    double wheel = BenchmarkWheel();
+
+    std::printf("%u idle timers, %u ticks\n", TimerCount, TickCount);
+    std::printf("  linear scan: %10.3f us/tick\n", linear);
+    std::printf("  timer wheel: %10.3f us/tick\n", wheel);
+    return 0;
+}